@@ -0,0 +1,293 @@
+"""
+Performance regression test of MicroHH over a fixed set of cases.
+
+Every case runs a fixed number of iterations with a constant time step and
+the timing of the modules enabled ([timing] swtiming=1). The second half of
+the run is repeated as a restart, which has to reproduce the fields of the
+full run bitwise, as in cases/restart_serial, for the cases that support it.
+
+The wall clock time per module (the slowest process) and the checksums of
+the final fields are compared against a stored baseline:
+
+    python regression.py --save   # store the baseline of the current build
+    python regression.py          # compare the current build to the baseline
+
+The test fails if a module is more than the tolerance slower than in the
+baseline, if the fields differ from those of the baseline (disable with
+--nobitwise in case of an intended change of the results), or if a
+restart does not reproduce the full run. The baseline depends on the
+machine and the build settings, store it on the machine that runs the test.
+"""
+
+from __future__ import print_function
+
+import argparse
+import hashlib
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+
+# The cases with their directory in cases/, the profile script, the constant time step,
+# the precision of the output times and the settings that are changed to make the runs short.
+# The time step is an exact multiple of 10^iotimeprec, such that the restart time is as well.
+# The surface model is not restarted bitwise, as the first guess of its Obukhov length
+# iteration is not saved, hence the restart of bomex is not checked.
+cases = [
+    { 'name'      : 'drycbl',
+      'directory' : 'drycbl',
+      'profscript': 'drycblprof.py',
+      'dt'        : 0.001,
+      'iotimeprec': -3,
+      'restart'   : True,
+      'settings'  : { 'grid': { 'itot': 128 } } },
+
+    { 'name'      : 'bomex',
+      'directory' : 'bomex',
+      'profscript': 'bomexprof.py',
+      'dt'        : 6.,
+      'iotimeprec': 0,
+      'restart'   : False,
+      'settings'  : {} },
+
+    { 'name'      : 'moser180',
+      'directory' : 'moser180',
+      'profscript': 'moser180prof.py',
+      'dt'        : 0.2,
+      'iotimeprec': -1,
+      'restart'   : True,
+      'settings'  : { 'grid': { 'itot': 64, 'jtot': 48 } } },
+
+    { 'name'      : 'taylorgreen',
+      'directory' : 'taylorgreen/taylorgreen64_4m',
+      'profscript': 'taylorgreenprof.py',
+      'dt'        : 0.0025,
+      'iotimeprec': -4,
+      'restart'   : True,
+      'settings'  : { 'cross': { 'swcross': 0 } } },
+]
+
+
+def set_ini_values(ini_file, settings):
+    """ Set the items of a .ini file, items and blocks that do not exist are added """
+    with open(ini_file, 'r') as f:
+        lines = f.readlines()
+
+    for block, items in settings.items():
+        for item, value in items.items():
+            line_new = '{}={}\n'.format(item, value)
+
+            # Search the block and the item within the block
+            block_start = None
+            block_end   = len(lines)
+            item_line   = None
+            for n, line in enumerate(lines):
+                lstrip = line.strip()
+                if lstrip.startswith('['):
+                    if block_start is not None:
+                        block_end = n
+                        break
+                    if lstrip == '[{}]'.format(block):
+                        block_start = n
+                elif block_start is not None and lstrip.split('=')[0].strip() == item:
+                    item_line = n
+
+            if item_line is not None:
+                lines[item_line] = line_new
+            elif block_start is not None:
+                lines.insert(block_end, line_new)
+            else:
+                lines += ['\n', '[{}]\n'.format(block), line_new]
+
+    with open(ini_file, 'w') as f:
+        f.writelines(lines)
+
+
+def run(command, log):
+    """ Run a command and stop the test if it fails """
+    if subprocess.call(command, stdout=log, stderr=subprocess.STDOUT) != 0:
+        raise RuntimeError('\"{}\" failed, see {}'.format(' '.join(command), log.name))
+
+
+def read_timings(timing_file):
+    """ Sum the time per module of the slowest process over all the output intervals """
+    timings = {}
+    with open(timing_file, 'r') as f:
+        for line in f:
+            cols = line.split()
+            if cols[0] == 'ITER':
+                continue
+            timings[cols[2]] = timings.get(cols[2], 0.) + float(cols[6])
+    return timings
+
+
+def get_field_files(iotime):
+    """ Find the restart files that are written at the given output time """
+    return sorted(f for f in os.listdir('.') if re.match(r'^\w+\.{0:07d}$'.format(iotime), f))
+
+
+def checksum(filename):
+    with open(filename, 'rb') as f:
+        return hashlib.md5(f.read()).hexdigest()
+
+
+def run_case(case, args):
+    """ Run a case and its restart, return the timings, checksums and the restart result """
+    casedir = os.path.join(args.casedir, case['directory'])
+    workdir = os.path.join(args.workdir, case['name'])
+
+    if os.path.exists(workdir):
+        shutil.rmtree(workdir)
+    os.makedirs(workdir)
+
+    simname = case['profscript'][:-len('prof.py')]
+    shutil.copy(os.path.join(casedir, simname + '.ini'), workdir)
+    shutil.copy(os.path.join(casedir, case['profscript']), workdir)
+
+    # The run saves the fields halfway and at the end, the restart starts halfway.
+    endtime     = args.niter * case['dt']
+    restarttime = endtime / 2
+    iotimeprec  = case['iotimeprec']
+
+    settings = {
+        'master': { 'npx': args.npx, 'npy': args.npy },
+        'time'  : { 'adaptivestep': 'false', 'dt': case['dt'], 'dtmax': case['dt'],
+                    'starttime': 0, 'endtime': endtime, 'savetime': restarttime,
+                    'outputiter': args.niter, 'iotimeprec': iotimeprec },
+        'stats' : { 'sampletime': restarttime },
+        'timing': { 'swtiming': 1 } }
+    for block, items in case['settings'].items():
+        settings.setdefault(block, {}).update(items)
+
+    microhh  = args.launcher.split() + [os.path.abspath(args.microhh)]
+    cwd      = os.getcwd()
+    os.chdir(workdir)
+
+    try:
+        ini_file = simname + '.ini'
+        set_ini_values(ini_file, settings)
+
+        with open('log.txt', 'w') as log:
+            run([sys.executable, case['profscript']], log)
+            run(microhh + ['init', simname], log)
+            run(microhh + ['run' , simname], log)
+
+            timings = read_timings(simname + '.timing')
+
+            endiotime = int(round(endtime / 10.**iotimeprec))
+            fields    = get_field_files(endiotime)
+            checksums = dict((f.split('.')[0], checksum(f)) for f in fields)
+
+            # Store the fields at the end of the full run as reference for the restart.
+            restart = None
+            if case['restart']:
+                for f in fields:
+                    os.rename(f, f + 'ref')
+
+                set_ini_values(ini_file, { 'time': { 'starttime': restarttime } })
+                run(microhh + ['run', simname], log)
+
+                restart = (get_field_files(endiotime) == fields) and \
+                          all(checksum(f) == checksum(f + 'ref') for f in fields)
+    finally:
+        os.chdir(cwd)
+
+    return { 'timings': timings, 'checksums': checksums, 'restart': restart }
+
+
+def compare(case, result, base, args):
+    """ Print the comparison with the baseline and return the number of failures """
+    name   = case['name']
+    nerror = 0
+
+    print('{:<12s} {:<10s} {:>11s} {:>11s} {:>8s}'.format('CASE', 'MODULE', 'BASE', 'NEW', 'RATIO'))
+    for module in sorted(base['timings']):
+        tbase = base['timings'][module]
+        tnew  = result['timings'].get(module)
+        if tnew is None:
+            print('{:<12s} {:<10s} {:11.4E} {:>11s}   MISSING'.format(name, module, tbase, '-'))
+            nerror += 1
+            continue
+
+        ratio  = tnew / tbase if tbase > 0. else 1.
+        failed = tnew > (1. + args.tolerance)*tbase and tnew - tbase > args.mintime
+        print('{:<12s} {:<10s} {:11.4E} {:11.4E} {:8.3f}{}'.format(
+              name, module, tbase, tnew, ratio, '   SLOWER' if failed else ''))
+        nerror += failed
+
+    if case['restart'] and not result['restart']:
+        print('{}: the restart does not reproduce the fields of the full run'.format(name))
+        nerror += 1
+
+    if args.bitwise:
+        for field in sorted(base['checksums']):
+            if result['checksums'].get(field) != base['checksums'][field]:
+                print('{}: field \"{}\" is not bitwise identical to the baseline'.format(name, field))
+                nerror += 1
+
+    return nerror
+
+
+if __name__ == '__main__':
+    scriptdir = os.path.dirname(os.path.abspath(__file__))
+
+    parser = argparse.ArgumentParser(description='Performance regression test of MicroHH')
+    parser.add_argument('--microhh'  , default='./microhh', help='MicroHH executable')
+    parser.add_argument('--launcher' , default='', help='prefix of the MicroHH command, e.g. \"mpiexec -n 4\"')
+    parser.add_argument('--npx'      , type=int, default=1)
+    parser.add_argument('--npy'      , type=int, default=1)
+    parser.add_argument('--niter'    , type=int, default=20, help='number of iterations, an even number')
+    parser.add_argument('--baseline' , default=os.path.join(scriptdir, 'baseline.json'))
+    parser.add_argument('--save'     , action='store_true', help='store the results as the baseline')
+    parser.add_argument('--tolerance', type=float, default=0.1, help='allowed relative slowdown per module')
+    parser.add_argument('--mintime'  , type=float, default=0.05, help='slowdowns below this time (s) are ignored')
+    parser.add_argument('--nobitwise', dest='bitwise', action='store_false', help='do not compare the fields')
+    parser.add_argument('--casedir'  , default=os.path.join(scriptdir, '..'))
+    parser.add_argument('--workdir'  , default='regression_run')
+    parser.add_argument('--cases'    , nargs='+', default=[c['name'] for c in cases])
+    args = parser.parse_args()
+
+    if args.niter % 2 != 0:
+        parser.error('niter has to be an even number')
+
+    # The settings that determine the baseline, comparisons with other settings are meaningless.
+    setup = { 'niter': args.niter, 'npx': args.npx, 'npy': args.npy, 'launcher': args.launcher }
+
+    if not args.save:
+        if not os.path.exists(args.baseline):
+            sys.exit('ERROR baseline \"{}\" does not exist, create it with --save'.format(args.baseline))
+        with open(args.baseline, 'r') as f:
+            baseline = json.load(f)
+        if baseline['setup'] != setup:
+            sys.exit('ERROR the baseline was made with {}, not with {}'.format(baseline['setup'], setup))
+
+    results = {}
+    nerror  = 0
+    for case in cases:
+        if case['name'] not in args.cases:
+            continue
+
+        print('Running {}'.format(case['name']))
+        results[case['name']] = run_case(case, args)
+
+        if not args.save:
+            if case['name'] not in baseline['cases']:
+                print('{}: no baseline available'.format(case['name']))
+                nerror += 1
+            else:
+                nerror += compare(case, results[case['name']], baseline['cases'][case['name']], args)
+
+    if args.save:
+        failed = [c['name'] for c in cases if c['name'] in results and c['restart'] and not results[c['name']]['restart']]
+        if failed:
+            sys.exit('ERROR the restart does not reproduce the full run of {}, baseline not saved'.format(', '.join(failed)))
+        with open(args.baseline, 'w') as f:
+            json.dump({ 'setup': setup, 'cases': results }, f, indent=2, sort_keys=True)
+        print('Saved baseline \"{}\"'.format(args.baseline))
+    elif nerror == 0:
+        print('TEST PASSED!')
+    else:
+        print('TEST FAILED!')
+        sys.exit(1)
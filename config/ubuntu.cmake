@@ -13,6 +13,7 @@ set(USER_CXX_FLAGS_DEBUG "-O0 -g -Wall -Wno-unknown-pragmas")
 
 set(FFTW_INCLUDE_DIR   "/usr/include")
 set(FFTW_LIB           "/usr/lib/x86_64-linux-gnu/libfftw3.so")
+set(FFTW_OMP_LIB       "/usr/lib/x86_64-linux-gnu/libfftw3_omp.so")
 set(NETCDF_INCLUDE_DIR "/usr/include")
 set(NETCDF_LIB_C       "/usr/lib/x86_64-linux-gnu/libnetcdf.so")
 set(NETCDF_LIB_CPP     "/usr/lib/x86_64-linux-gnu/libnetcdf_c++4.so")
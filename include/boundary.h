@@ -56,7 +56,7 @@ class Boundary
         virtual void exec(); ///< Update the boundary conditions.
         virtual void set_ghost_cells_w(Boundary_w_type); ///< Update the boundary conditions.
 
-        virtual void exec_stats(Mask*); ///< Execute statistics of surface
+        virtual void exec_stats(); ///< Execute statistics of surface
         virtual void exec_cross();       ///< Execute cross sections of surface
 
         virtual void get_mask(Field3d*, Field3d*, Mask*); ///< Calculate statistics mask
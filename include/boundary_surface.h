@@ -41,7 +41,7 @@ class Boundary_surface : public Boundary
         void create(Input*);
         virtual void set_values();
 
-        void exec_stats(Mask*); ///< Execute statistics of surface
+        void exec_stats(); ///< Execute statistics of surface
         void exec_cross();      ///< Execute cross sections of surface
 
         // Make these variables public for out-of-class usage.
@@ -24,6 +24,7 @@
 #define BUDGET
 
 #include <string>
+#include <vector>
 
 class Input;
 class Master;
@@ -52,6 +53,7 @@ class Budget
         virtual void init() = 0;
         virtual void create() = 0;
         virtual void exec_stats(Mask*) = 0;
+        void exec_stats_masks(); ///< Calculate the budgets once and store them in all active masks.
 
     protected:
         Master& master;
@@ -64,6 +66,9 @@ class Budget
         Stats&  stats;
 
         std::string swbudget;
+
+        std::vector<std::string> prof_names; ///< Names of the budget profiles.
+        void add_prof(std::string, std::string, std::string, std::string); ///< Add a budget profile to the statistics.
 };
 #endif
 
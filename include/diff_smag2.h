@@ -70,6 +70,8 @@ class Diff_smag_2 : public Diff
                                 double*, double*,
                                 double, double);
 
+        void calc_evisc_wall(double*, double);
+
         template<bool>
         void diff_u(double*, double*, double*, double*, double*, double*, double*, double*, double*, double*, double*);
         template<bool>
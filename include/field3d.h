@@ -35,7 +35,12 @@ class Field3d
         Field3d(Grid*, Master*, std::string, std::string, std::string);
         ~Field3d();
 
+#ifndef USECUDA
+        int init(double*, bool);              ///< Assigns the arrays of the field, with or without the 2d arrays, to a block of memory_size() doubles.
+        static long memory_size(Grid*, bool); ///< Number of doubles of a field with its arrays aligned at 64 bytes.
+#else
         int init();
+#endif
         // int checkfornan();
 
         // variables at CPU
@@ -24,6 +24,7 @@
 #define FIELDS
 #include <map>
 #include <vector>
+#include <utility>
 #include "field3d.h"
 
 class Master;
@@ -48,7 +49,7 @@ class Fields
 
         void exec();
         void get_mask(Field3d*, Field3d*, Mask*);
-        void exec_stats(Mask*);
+        void exec_stats();
 
         void init_momentum_field  (Field3d*&, Field3d*&, std::string, std::string, std::string);
         void init_prognostic_field(std::string, std::string, std::string);
@@ -64,6 +65,8 @@ class Fields
 
         void set_calc_mean_profs(bool);
         void set_minimum_tmp_fields(int);
+        void set_minimum_tmp_fields_2d(int); ///< Sets the minimum number of tmp fields with the 2d boundary arrays.
+        void set_minimum_tmp_fields_xz(int, int); ///< Sets the minimum number of tmp fields for fields and xz slices that are borrowed at the same time.
 
         void exec_cross();
         void exec_dump();
@@ -124,6 +127,14 @@ class Fields
 
         bool calc_mean_profs;
 
+        double* field_memory; ///< Block of memory that contains the arrays of all fields.
+
+        // pool of tmp fields, borrowed through Tmp_fields
+        friend class Tmp_fields;
+        std::vector<Field3d*> tmp_pool; ///< Tmp fields that are available for borrowing.
+        Field3d* get_tmp(bool);         ///< Borrows a tmp field, with the 2d boundary arrays if requested.
+        void release_tmp(Field3d*);     ///< Returns a borrowed tmp field to the pool.
+
         // cross sections
         std::vector<std::string> crosslist; ///< List with all crosses from the ini file.
         std::vector<std::string> dumplist;  ///< List with all 3d dumps from the ini file.
@@ -159,11 +170,13 @@ class Fields
         int randomize    (Input*, std::string, double*);
         int add_vortex_pair(Input*);
 
-        // statistics
-        double* umodel;
-        double* vmodel;
+        // statistics, the mean velocities of each mask
+        std::vector<double> umodel;
+        std::vector<double> vmodel;
 
         int n_tmp_fields;   // number of temporary fields
+        int n_tmp_fields_2d; // number of temporary fields with 2d boundary arrays
+        std::vector<std::pair<int, int> > n_tmp_fields_xz; // fields and xz slices, converted into tmp fields at init
 
         /* 
          *Device (GPU) functions and variables
@@ -171,4 +184,37 @@ class Fields
         void forward_field3d_device(Field3d *);  ///< Copy of a complete Field3d instance from host to device
         void backward_field3d_device(Field3d *); ///< Copy of a complete Field3d instance from device to host
 };
+
+/**
+ * Scoped borrowing of tmp fields from the pool in Fields.
+ * The fields and slices that are borrowed through an instance are returned to the pool when it goes
+ * out of scope. Modules borrow their scratch space this way in the routines that run every time step,
+ * the number of tmp fields that are in use at the same time should not exceed what they have set with
+ * set_minimum_tmp_fields or set_minimum_tmp_fields_xz. Modules whose demand depends on the grid borrow
+ * their worst case once in init(), such that a pool that is too small is found before the time loop.
+ * Access to the tmp fields by name is only allowed outside of these scopes.
+ */
+class Tmp_fields
+{
+    public:
+        Tmp_fields(Fields*);
+        ~Tmp_fields();
+
+        Field3d* get_field(bool with2d=false); ///< Borrows a full tmp field.
+        double*  get_slice(int);               ///< Borrows an array of the given size, packed with other slices into tmp fields.
+
+        static int get_slice_size(int);        ///< Size that a slice of the given size takes in a tmp field.
+
+    private:
+        Fields* fields;
+        Grid* grid;
+
+        std::vector<Field3d*> borrowed;
+
+        double* slice_data; ///< Data of the tmp field from which the slices are taken.
+        int slice_used;     ///< Number of doubles of slice_data that are in use.
+
+        Tmp_fields(const Tmp_fields&);            // Borrowed fields cannot be shared.
+        Tmp_fields& operator=(const Tmp_fields&);
+};
 #endif
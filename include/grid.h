@@ -27,6 +27,11 @@
 #include <mpi.h>
 #endif
 #include <fftw3.h>
+#include <vector>
+#ifdef USEMPI
+#include <map>
+#include <tuple>
+#endif
 #include "input.h"
 
 class Model;
@@ -52,6 +57,8 @@ class Grid
         void save();         ///< Saves grid data to file.
         void load();         ///< Loads grid data to file.
 
+        void create_fft_plans(); ///< Creates the FFTW3 plans of the x and y transforms.
+
         int itot; ///< Total number of grid cells in the x-direction.
         int jtot; ///< Total number of grid cells in the y-direction.
         int ktot; ///< Total number of grid cells in the z-direction.
@@ -111,6 +118,9 @@ class Grid
         double vtrans; ///< Galilean transformation velocity in y-direction.
 
         std::string swspatialorder; ///< Default spatial order of the operators to be used on this grid.
+        std::string swtranspose;    ///< Communication backend of the transposes: p2p, alltoall or auto.
+        int fftchunks;              ///< Number of chunks of levels in which the transposes are pipelined with the FFTs.
+        std::string swrowpadding;   ///< Switch to pad the rows of the fields (icells) to avoid cache conflicts.
 
         void set_minimum_ghost_cells(int, int, int);
 
@@ -118,6 +128,9 @@ class Grid
         void init_mpi(); ///< Creates the MPI data types used in grid operations.
         void exit_mpi(); ///< Destructs the MPI data types used in grid operations.
         void boundary_cyclic   (double*, Edge=Both_edges); ///< Fills the ghost cells in the periodic directions.
+        void boundary_cyclic_start (double*, Edge=Both_edges); ///< Starts filling the ghost cells, the interior may not be changed until finished.
+        void boundary_cyclic_finish(double*, Edge=Both_edges); ///< Waits for the ghost cells started with boundary_cyclic_start.
+        void boundary_cyclic   (const std::vector<double*>&); ///< Fills the ghost cells of a set of fields in one exchange.
         void boundary_cyclic_2d(double*); ///< Fills the ghost cells of one slice in the periodic direction.
         void transpose_zx(double*, double*); ///< Changes the transpose orientation from z to x.
         void transpose_xz(double*, double*); ///< Changes the transpose orientation from x to z.
@@ -146,6 +159,8 @@ class Grid
         double*fftinj, *fftoutj; ///< Help arrays for fast-fourier transforms in y-direction.
         fftw_plan iplanf, iplanb; ///< FFTW3 plans for forward and backward transforms in x-direction.
         fftw_plan jplanf, jplanb; ///< FFTW3 plans for forward and backward transforms in y-direction.
+        fftw_plan iplanfblock, iplanbblock; ///< FFTW3 plans for in-place transforms of a chunk of levels in x-direction.
+        fftw_plan jplanfblock, jplanbblock; ///< FFTW3 plans for in-place transforms of a chunk of levels in y-direction.
 
         void fft_forward (double*, double*, double*, double*, double*, double*); ///< Forward fast-fourier transform.
         void fft_backward(double*, double*, double*, double*, double*, double*); ///< Backward fast-fourier transform.
@@ -189,12 +204,54 @@ class Grid
         void calculate(); ///< Computation of dimensions, faces and ghost cells.
         void check_ghost_cells(); ///< Check whether slice thickness is at least equal to number of ghost cells.
 
+        void create_fft_block_plans(); ///< Creates the FFTW3 plans that transform a chunk of levels at once.
+        void fft_block(fftw_plan, fftw_plan, double*, double*, double*, double*, int, int, double); ///< Transforms a chunk of levels.
+
 #ifdef USEMPI
         // MPI Datatypes
         MPI_Datatype eastwestedge;     ///< MPI datatype containing the ghostcells at the east-west sides.
         MPI_Datatype northsouthedge;   ///< MPI datatype containing the ghostcells at the north-south sides.
         MPI_Datatype eastwestedge2d;   ///< MPI datatype containing the ghostcells for one slice at the east-west sides.
         MPI_Datatype northsouthedge2d; ///< MPI datatype containing the ghostcells for one slice at the north-south sides.
+        MPI_Datatype eastwestedgeinner;   ///< MPI datatype containing the ghostcells at the east-west sides without the corners.
+        MPI_Datatype northsouthedgeinner; ///< MPI datatype containing the ghostcells at the north-south sides without the corners.
+        MPI_Datatype corneredge;          ///< MPI datatype containing the ghostcells in one of the four corners.
+
+        std::vector<double> halosend; ///< Buffer for the packed ghost cells of multiple fields to send.
+        std::vector<double> halorecv; ///< Buffer for the packed ghost cells of multiple fields to receive.
+
+        // Persistent requests, created at the first use of a communication pattern and restarted afterwards.
+        enum Comm_pattern {Halo_3d, Halo_2d, Halo_multi,
+                           Transpose_zx, Transpose_xz, Transpose_xy, Transpose_yx, Transpose_yz, Transpose_zy,
+                           Transpose_zx_chunks, Transpose_xy_chunks, Transpose_zy_chunks, Transpose_yx_chunks};
+        typedef std::tuple<int, int, const double*, const double*> Request_key;
+        std::map<Request_key, std::vector<MPI_Request> > persistent_requests; ///< Requests per pattern, variant and pair of buffers.
+        std::vector<MPI_Request>& get_requests(Comm_pattern, int, const double*, const double*); ///< Returns the requests of a pattern, empty if not yet created.
+        void free_requests(const double*); ///< Frees the persistent requests that use the given buffer.
+
+        // Alltoall transposes, each partner exchanges a block of ni*nj*nk cells that starts at n*(di,dj,dk).
+        struct Transpose_block
+        {
+            int ni, nj, nk;
+            int di, dj, dk;
+            int jj, kk;
+        };
+        bool alltoall_transpose;                ///< Switch to use MPI_Alltoall instead of point-to-point messages in the transposes.
+        Transpose_block blockz;  ///< Block of the z-orientation in the zx-transpose.
+        Transpose_block blockz2; ///< Block of the z-orientation in the zy-transpose.
+        Transpose_block blockx;  ///< Block of the x-orientation in the zx-transpose.
+        Transpose_block blockx2; ///< Block of the x-orientation in the xy-transpose.
+        Transpose_block blocky;  ///< Block of the y-orientation in the xy-transpose.
+        Transpose_block blocky2; ///< Block of the y-orientation in the zy-transpose.
+        std::vector<double> transposesend;      ///< Buffer for the packed blocks to send in the alltoall transposes.
+        std::vector<double> transposerecv;      ///< Buffer for the packed blocks to receive in the alltoall transposes.
+        void transpose_alltoall(double*, const double*, MPI_Comm, int, int, const Transpose_block&, const Transpose_block&);
+        void tune_transposes(); ///< Times both transpose backends and selects the fastest.
+
+        // Transposes in chunks of levels, such that the FFTs of one chunk overlap with the communication of the next.
+        std::vector<MPI_Request>& transpose_chunks_start(Comm_pattern, double*, double*); ///< Starts the transposes of all chunks.
+        void transpose_chunk_wait(Comm_pattern, std::vector<MPI_Request>&, int); ///< Waits for the transpose of one chunk.
+        int chunk_site(Comm_pattern); ///< Returns the profiler call site of a chunked transpose.
 
         MPI_Datatype transposez;  ///< MPI datatype containing base blocks for z-orientation in zx-transpose.
         MPI_Datatype transposez2; ///< MPI datatype containing base blocks for z-orientation in zy-transpose.
@@ -203,6 +260,13 @@ class Grid
         MPI_Datatype transposey;  ///< MPI datatype containing base blocks for y-orientation in xy-transpose.
         MPI_Datatype transposey2; ///< MPI datatype containing base blocks for y-orientation in zy-transpose.
 
+        MPI_Datatype transposezlevel;  ///< MPI datatype containing one level of a base block for z-orientation in zx-transpose.
+        MPI_Datatype transposez2level; ///< MPI datatype containing one level of a base block for z-orientation in zy-transpose.
+        MPI_Datatype transposexlevel;  ///< MPI datatype containing one level of a base block for x-orientation in zx-transpose.
+        MPI_Datatype transposex2level; ///< MPI datatype containing one level of a base block for x-orientation in xy-transpose.
+        MPI_Datatype transposeylevel;  ///< MPI datatype containing one level of a base block for y-orientation in xy-transpose.
+        MPI_Datatype transposey2level; ///< MPI datatype containing one level of a base block for y-orientation in zy-transpose.
+
         MPI_Datatype subi;       ///< MPI datatype containing a subset of the entire x-axis.
         MPI_Datatype subj;       ///< MPI datatype containing a subset of the entire y-axis.
         MPI_Datatype subarray;   ///< MPI datatype containing the dimensions of the total array that is contained in one process.
@@ -35,11 +35,15 @@ typedef std::map<std::string, std::vector<double> > Data_map;
 class Input
 {
     public:
-        Input(Master*);
+        Input(Master*, bool readfiles=true);
         ~Input();
 
         void clear();
 
+        // Item setting functions, to build the input in memory without files
+        void set_item(std::string, std::string, std::string, std::string);
+        void set_prof(std::string, const std::vector<double>&);
+
         // Item retrieval functions
         int get_item(int*        , std::string, std::string, std::string);
         int get_item(int*        , std::string, std::string, std::string, int);
@@ -62,8 +66,12 @@ class Input
         void print_unused();
         void flag_as_used(std::string, std::string);
 
+        // Suppress the echo of the retrieved items, for inputs that are built repeatedly in memory.
+        void set_quiet(bool);
+
     private:
         Master* master;
+        bool quiet;
 
         int read_ini_file();
         int read_data_file(Data_map*, std::string, bool);
@@ -27,10 +27,19 @@
 #include <mpi.h>
 #endif
 #include <string>
+#include <vector>
 #include "input.h"
 
 class Input;
 
+// Call sites of the communication profiler.
+enum Comm_site {Comm_boundary_cyclic, Comm_boundary_cyclic_multi, Comm_boundary_cyclic_2d,
+                Comm_transpose_zx, Comm_transpose_xz, Comm_transpose_xy,
+                Comm_transpose_yx, Comm_transpose_yz, Comm_transpose_zy,
+                Comm_master_sum, Comm_master_max, Comm_master_min,
+                Comm_grid_get_max, Comm_grid_get_sum, Comm_grid_get_prof,
+                Ncomm_sites};
+
 class Master
 {
     public:
@@ -43,8 +52,6 @@ class Master
         double get_wall_clock_time();
         bool at_wall_clock_limit();
 
-        void wait_all();
-
         // overload the broadcast function
         void broadcast(char *, int);
         void broadcast(int *, int);
@@ -61,6 +68,13 @@ class Master
         // overload the min function
         void min(double *, int);
 
+        // communication profiler
+        double comm_start();
+        void comm_stop(int, double, double, int);
+        void pause_comm_profile();
+        void resume_comm_profile();
+        void print_comm_profile();
+
         void print_message(const char *format, ...);
         void print_warning(const char *format, ...);
         void print_error  (const char *format, ...);
@@ -71,6 +85,7 @@ class Master
         int nprocs;
         int npx;
         int npy;
+        int nthreads;
         int mpiid;
         int mpicoordx;
         int mpicoordy;
@@ -80,13 +95,14 @@ class Master
         int nsouth;
         int neast;
         int nwest;
+        int nnortheast;
+        int nnorthwest;
+        int nsoutheast;
+        int nsouthwest;
 
         MPI_Comm commxy;
         MPI_Comm commx;
         MPI_Comm commy;
-
-        MPI_Request *reqs;
-        int reqsn;
 #endif
 
     private:
@@ -96,6 +112,17 @@ class Master
         double wall_clock_start;
         double wall_clock_end;
 
+        void init_threads();
+
+        std::string swcommprofile; ///< Switch for the communication profiler.
+        bool comm_paused;                  ///< Communication is not counted while paused.
+        std::vector<double> comm_time;     ///< Time spent per call site.
+        std::vector<double> comm_bytes;    ///< Bytes sent per call site.
+        std::vector<double> comm_messages; ///< Messages sent per call site.
+        std::vector<double> comm_calls;    ///< Number of communicating calls per call site.
+
+        void init_comm_profile();
+
 #ifdef USEMPI
         int check_error(int);
 #endif
@@ -41,6 +41,7 @@ class Stats;
 class Cross;
 class Dump;
 class Budget;
+class Timing;
 
 class Model
 {
@@ -76,6 +77,9 @@ class Model
         Dump*   dump;
         Budget* budget;
 
+        // Wall clock timing of the modules.
+        Timing* timing;
+
     private:
         // list of masks for statistics
         std::vector<std::string> masklist;
@@ -83,7 +87,7 @@ class Model
         void delete_objects();
 
         void print_status();
-        void calc_stats(std::string);
+        void calc_stats();
         void set_time_step();
 };
 #endif
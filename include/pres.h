@@ -23,6 +23,8 @@
 #ifndef PRES
 #define PRES
 
+#include <string>
+
 class Model;
 class Grid;
 class Fields;
@@ -53,6 +55,8 @@ class Pres
         Grid*   grid;
         Fields* fields;
 
+        std::string swlucache; ///< Switch to factorize the Poisson matrix once in set_values().
+
 #ifdef USECUDA
         void make_cufft_plan();
         void fft_forward (double*, double*, double*);
@@ -50,6 +50,9 @@ class Pres_2 : public Pres
         double* a;
         double* c;
         double* work2d;
+        double* work_col; // per thread work array of the blocked tridiagonal solver
+        double* lu_bet;   // stored diagonal of the factorized systems
+        double* lu_gam;   // stored ratios of the factorized systems
 
 #ifdef USECUDA
         double* bmati_g;
@@ -65,15 +68,18 @@ class Pres_2 : public Pres
                    double*, double*, double*,
                    double);
 
-        void solve(double*, double*, double*,
+        void solve(double*, double*,
                    double*, double*,
                    double*, double*, double*, double*);
 
         void output(double*, double*, double*,
                     double*, double*);
 
-        void tdma(double*, double*, double*, double*, 
+        void factorize(double*, double*, double*, double*);
+
+        void tdma(double*, double*, double*,
                   double*, double*);
+        void tdma_lu(double*, double*, double*);
 
         double calc_divergence(double*, double*, double*, double*, double*, double*);
 };
@@ -59,6 +59,7 @@ class Pres_4 : public Pres
         double* m5;
         double* m6;
         double* m7;
+        double* lu_m; ///< Factorized matrices of all slices, only if swlucache is enabled.
 
 #ifdef USECUDA
         double* bmati_g;
@@ -97,9 +98,20 @@ class Pres_4 : public Pres
         void output(double* restrict, double* restrict, double* restrict,
                     double* restrict, double* restrict);
 
-        void hdma(double* restrict, double* restrict, double* restrict, double* restrict,
-                  double* restrict, double* restrict, double* restrict, double* restrict,
-                  int);
+        void build_matrix(double* restrict, double* restrict, double* restrict, double* restrict,
+                          double* restrict, double* restrict, double* restrict,
+                          double* restrict, double* restrict, double* restrict, double* restrict,
+                          double* restrict, double* restrict, double* restrict,
+                          double* restrict, double* restrict,
+                          int, int);
+
+        void hdma_factor(double* restrict, double* restrict, double* restrict, double* restrict,
+                         double* restrict, double* restrict, double* restrict,
+                         int);
+
+        void hdma_solve(double* restrict, double* restrict, double* restrict, double* restrict,
+                        double* restrict, double* restrict, double* restrict, double* restrict,
+                        int);
 
         double calc_divergence(double* restrict, double* restrict, double* restrict, double* restrict);
 };
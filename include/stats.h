@@ -24,6 +24,13 @@
 #define STATS
 
 //#include <netcdfcpp.h>
+#include <map>
+#include <utility>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <netcdf>
 using namespace netCDF;
 
@@ -66,6 +73,9 @@ struct Mask
 
 typedef std::map<std::string, Mask> Mask_map;
 
+// the data of a statistic in each of the active masks
+typedef std::vector<double*> Mask_data;
+
 class Stats
 {
     public:
@@ -93,42 +103,159 @@ class Stats
         void add_fixed_prof(std::string, std::string, std::string, std::string, double*);
         void add_time_series(std::string, std::string, std::string);
 
-        void calc_area(double*, const int[3], int*);
+        // Masks of which the statistics are calculated in a single sweep over the fields.
+        void add_active_mask(Mask*, Field3d*, Field3d*);
+        void clear_active_masks();
+        int get_nmasks();
+        Mask* get_active_mask(int);
+
+        Mask_data get_profs(const std::string);
+        Mask_data get_time_series(const std::string);
+
+        // Kernels that calculate a statistic for all active masks. The variables
+        // at the half levels (loc[2] == 1), the gradients, fluxes and diffusion use the mask
+        // of the half levels, the masks are interpolated horizontally to the location of the variable.
+        void calc_area(const Mask_data&, const int[3]);
 
-        void calc_mean(double* const, const double* const,
-                       const double, const int[3],
-                       const double* const, const int* const);
+        void calc_mean(const Mask_data&, const double* const,
+                       const double, const int[3]);
 
-        void calc_mean2d(double* const, const double* const,
-                         const double,
-                         const double* const, const int* const);
+        void calc_mean2d(const Mask_data&, const double* const,
+                         const double);
 
-        void calc_moment  (double*, double*, double*, double, const int[3], double*, int*);
+        void calc_moment  (const double* const, const Mask_data&, const Mask_data&, const double, const int[3]);
+        void calc_moments (const Mask_data&, const Mask_data&, const Mask_data&, const Mask_data&,
+                           const double* const, const double, const int[3]);
 
-        void calc_diff_2nd(double*, double*, double*, double, const int[3], double*, int*);
-        void calc_diff_2nd(double*, double*, double*, double*, double*,
-                           double*, double*, double, const int[3], double*, int*);
-        void calc_diff_4th(double*, double*, double*, double, const int[3], double*, int*);
+        void calc_diff_2nd(const double* const, const Mask_data&, const double* const, const double, const int[3]);
+        void calc_diff_2nd(const double* const, const double* const, const double* const, const Mask_data&,
+                           const double* const, const double* const, const double* const, const double, const int[3]);
+        void calc_diff_4th(const double* const, const Mask_data&, const double* const, const double, const int[3]);
 
-        void calc_grad_2nd(double*, double*, double*, const int[3], double*, int*);
-        void calc_grad_4th(double*, double*, double*, const int[3], double*, int*);
+        void calc_grad_2nd(const double* const, const Mask_data&, const double* const, const int[3]);
+        void calc_grad_4th(const double* const, const Mask_data&, const double* const, const int[3]);
 
-        void calc_flux_2nd(double*, double*, double*, double*, double*, double*, const int[3], double*, int*);
-        void calc_flux_4th(double*, double*, double*, double*, const int[3], double*, int*);
+        void calc_flux_2nd(const double* const, const Mask_data&, double* const, const Mask_data&,
+                           const Mask_data&, double* const, const int[3]);
+        void calc_flux_4th(const double* const, double* const, const Mask_data&, double* const, const int[3]);
 
-        void add_fluxes   (double*, double*, double*);
-        void calc_count   (double*, double*, double, double*, int*);
-        void calc_path    (double*, double*, int*, double*);
-        void calc_cover   (double*, double*, int*, double*, double);
+        void add_fluxes   (const Mask_data&, const Mask_data&, const Mask_data&);
+        void calc_count   (const double* const, const Mask_data&, const double);
+        void calc_path    (const double* const, const Mask_data&);
+        void calc_cover   (const double* const, const Mask_data&, const double);
 
         void calc_sorted_prof(double*, double*, double*);
 
+        // Sum the profiles of the kernels above in one collective per batch.
+        void start_reductions();
+        void finish_reductions();
+
     private:
         int nstats;
 
+        // Profile of which the sum over the processes is pending.
+        struct Pending_prof
+        {
+            double* data;
+            int n;
+            const int* nmask;        // number of points per level, 0 if the sum is not normalized
+            int kbegin;              // first level that is normalized
+            const double* datamean;  // mean that needs to be defined at k-1 and k, 0 if none
+        };
+
+        // Total flux that waits for its pending turbulent and diffusive profiles.
+        struct Pending_flux
+        {
+            double* flux;
+            double* turb;
+            double* diff;
+        };
+
+        // Number of points of a mask for which statistics are calculated.
+        struct Active_mask
+        {
+            Mask* mask;
+            std::vector<int> nmask;
+            std::vector<int> nmaskh;
+            int nmaskbot;
+        };
+
+        static const int max_active_masks = 8;
+
+        std::vector<Active_mask> active_masks;
+        std::vector<unsigned char> mask_bits;    // bit n is set for the cells in active mask n
+        std::vector<unsigned char> mask_bitsh;   // idem at the half levels
+        std::vector<unsigned char> mask_bitsbot; // idem at the surface
+
+        const int* get_nmask(int, int);
+
+        // Runs of consecutive cells along the rows that the kernels visit, per level.
+        struct Mask_runs
+        {
+            std::vector<int> begin;          // index of the first cell of the run
+            std::vector<int> end;            // index beyond the last cell of the run
+            std::vector<unsigned int> masks; // bits of the masks for which the run is visited
+            std::vector<int> kbegin;         // first run of each level, one more than the number of levels
+        };
+
+        // runs per compact mask and shift of the horizontal interpolation
+        std::map<std::pair<const unsigned char*, int>, Mask_runs> mask_runs;
+
+        const Mask_runs& get_mask_runs(const unsigned char*, int);
+
+        // Local central moments that are completed once their mean is summed.
+        struct Pending_moments
+        {
+            double* mean;
+            double offset;               // offset that is included in the mean
+            double* prof[3];             // second, third and fourth moment
+            const int* nmask;
+            std::vector<double> sumw;    // local sum of the mask weights
+            std::vector<double> meanloc; // local weighted mean
+        };
+
+        bool batch_reductions;
+        std::vector<Pending_prof> pending_profs;
+        std::vector<Pending_flux> pending_fluxes;
+        std::vector<Pending_moments> pending_moments;
+        std::vector<double> reduce_buffer;
+
+        void reduce_prof(double*, int, const int*, int, const double*);
+        void reduce_pending();
+        bool is_pending(const double*);
+        bool is_pending(const Mask_data&);
+
+        void add_fluxes(double*, double*, double*);
+
         // mask calculations
         void calc_mask(double*, double*, double*, int*, int*, int*);
 
+        // Statistics of one sample that are written by the writer thread.
+        struct Stats_sample
+        {
+            int iteration;
+            double time;
+            size_t index;
+            bool sync;                // synchronize the files after writing
+            std::vector<double> data; // profiles and time series of all masks, in the order of the maps
+        };
+
+        std::string swasync;
+        int nqueue;      // maximum number of samples that wait to be written
+        int syncsamples; // synchronize the files every syncsamples samples, only at closing if 0
+
+        std::thread writer;
+        std::mutex writer_mutex;
+        std::condition_variable writer_cond;
+        std::deque<Stats_sample> writer_queue;
+        bool writer_stop;
+        bool writer_error;
+        std::string writer_message;
+
+        void write_sample(const Stats_sample&);
+        void run_writer();
+        void stop_writer();
+
     protected:
         Model*  model;
         Grid*   grid;
@@ -48,7 +48,7 @@ class Thermo
         virtual void exec() = 0;
         virtual unsigned long get_time_limit(unsigned long, double) = 0;
 
-        virtual void exec_stats(Mask*) = 0;
+        virtual void exec_stats() = 0;
         virtual void exec_cross() = 0;
         virtual void exec_dump() = 0;
 
@@ -54,7 +54,7 @@ class Thermo_buoy : public Thermo
         // Empty functions that are allowed to pass.
         void init() {}
         void create(Input*) {}
-        void exec_stats(Mask*) {}
+        void exec_stats() {}
         void exec_cross() {}
         void exec_dump() {}
         void get_mask(Field3d*, Field3d*, Mask*) {}
@@ -42,7 +42,7 @@ class Thermo_disabled : public Thermo
         void init() {}
         void create(Input*) {}
         void exec() {}
-        void exec_stats(Mask*) {}
+        void exec_stats() {}
         void exec_cross() {}
         void exec_dump() {}
         void get_mask(Field3d*, Field3d*, Mask*) {}
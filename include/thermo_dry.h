@@ -48,7 +48,7 @@ class Thermo_dry : public Thermo
         unsigned long get_time_limit(unsigned long, double); ///< Compute the time limit (n/a for thermo_dry)
 
 
-        void exec_stats(Mask*);
+        void exec_stats();
         void exec_cross();
         void exec_dump();
 
@@ -29,6 +29,7 @@ class Master;
 class Grid;
 class Fields;
 class Stats;
+class Tmp_fields;
 struct Mask;
 
 class Thermo_moist : public Thermo
@@ -43,7 +44,7 @@ class Thermo_moist : public Thermo
         unsigned long get_time_limit(unsigned long, double); ///< Compute the time limit (only for sw_micro=1)
 
         void get_mask(Field3d*, Field3d*, Mask*);
-        void exec_stats(Mask*);
+        void exec_stats();
         void exec_cross();
         void exec_dump();
 
@@ -123,5 +124,8 @@ class Thermo_moist : public Thermo
         double cflmax_micro; ///< Maximum allowed CFL for sedimentation.
         void exec_microphysics();
 
+        static const int n_micro_slices = 10; ///< Number of xz slices of the microphysics.
+        void get_micro_tmp(Tmp_fields&, double*&, double**); ///< Borrows the liquid water field and the xz slices of the microphysics.
+
 };
 #endif
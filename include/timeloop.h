@@ -81,8 +81,11 @@ class Timeloop
 
         int outputiter;
 
+        bool rkallfields; ///< Update all prognostic fields in a single loop nest.
+
         void rk3(double*, double*, double);
         void rk4(double*, double*, double);
+        void rk_all(double, double, double);
 
         double rk3subdt(double);
         double rk4subdt(double);
@@ -0,0 +1,85 @@
+/*
+ * MicroHH
+ * Copyright (c) 2011-2017 Chiel van Heerwaarden
+ * Copyright (c) 2011-2017 Thijs Heus
+ * Copyright (c) 2014-2017 Bart van Stratum
+ *
+ * This file is part of MicroHH
+ *
+ * MicroHH is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * MicroHH is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with MicroHH.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TIMING
+#define TIMING
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class Master;
+class Model;
+class Input;
+
+/**
+ * Class for the wall clock timing of the model modules.
+ * The time spent in each module is accumulated between two writes. Every outputiter
+ * the minimum, mean and maximum over all processes are written to <casename>.timing.
+ * Optionally, every call is stored as an event in a trace file per process.
+ */
+class Timing
+{
+    public:
+        Timing(Model*, Input*); ///< Constructor of the timing class.
+        ~Timing();              ///< Destructor of the timing class.
+
+        void start(const std::string&); ///< Start the timer of a module.
+        void stop (const std::string&); ///< Stop the timer of a module and add the elapsed time.
+
+        void exec(int, double); ///< Reduce the timers over all processes, write them and reset them.
+
+    private:
+        Master* master; ///< Pointer to master class.
+        Model*  model;  ///< Pointer to model class.
+
+        struct Timer
+        {
+            std::string name; ///< Name of the module.
+            double start;     ///< Wall clock time at the last start.
+            double total;     ///< Accumulated time since the last write.
+            int ncalls;       ///< Number of calls since the last write.
+        };
+
+        struct Event
+        {
+            int timer;    ///< Index of the timer.
+            double start; ///< Wall clock time at the start of the call.
+            double end;   ///< Wall clock time at the end of the call.
+        };
+
+        std::vector<Timer> timers; ///< Timers in the order of their first use.
+        std::vector<Event> events; ///< Events that are not yet written to the trace file.
+
+        std::string swtiming; ///< Switch for the timing of the modules.
+        std::string swtrace;  ///< Switch for the trace of all calls.
+
+        FILE* timingfile; ///< File the timings are written to.
+        bool timing_open; ///< The timing file is opened, or failed to open on all processes.
+        FILE* tracefile;  ///< File the events of this process are written to.
+
+        double trace_start; ///< Wall clock time that is the origin of the trace.
+
+        int get_timer(const std::string&); ///< Find the index of a timer, create it at first use.
+        void write_trace();                ///< Write the stored events to the trace file.
+};
+#endif
@@ -0,0 +1,355 @@
+/*
+ * MicroHH
+ * Copyright (c) 2011-2017 Chiel van Heerwaarden
+ * Copyright (c) 2011-2017 Thijs Heus
+ * Copyright (c) 2014-2017 Bart van Stratum
+ *
+ * This file is part of MicroHH
+ *
+ * MicroHH is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * MicroHH is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with MicroHH.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "master.h"
+#include "input.h"
+#include "model.h"
+#include "grid.h"
+#include "fields.h"
+#include "boundary.h"
+#include "advec.h"
+#include "diff.h"
+#include "pres.h"
+#include "thermo.h"
+#include "stats.h"
+
+namespace
+{
+    // Switches of one benchmarked model configuration.
+    struct Bench_case
+    {
+        std::string swspatialorder;
+        std::string swadvec;
+        std::string swdiff;
+        std::string swpres;
+        std::string swboundary;
+        std::string swthermo;
+    };
+
+    // The configurations cover all advection schemes, the diffusion schemes and both pressure solvers.
+    // Moist thermodynamics are only supported at second order, the fourth order cases are dry.
+    const Bench_case bench_cases[] =
+    {
+        {"2", "2"  , "2"    , "2", "default", "moist"},
+        {"2", "2i4", "smag2", "2", "surface", "moist"},
+        {"4", "4"  , "4"    , "4", "default", "dry"  },
+        {"4", "4m" , "4"    , "4", "default", "dry"  },
+    };
+
+    const double zsize = 3200.;
+
+    template<class T>
+    std::string to_string(const T value)
+    {
+        std::stringstream ss;
+        ss << value;
+        return ss.str();
+    }
+
+    // Fill the input with a moist convective boundary layer on a grid of the requested size.
+    void set_input(Input* input, const Bench_case& c, const int itot, const int jtot, const int ktot)
+    {
+        input->set_item("grid", "itot", "", to_string(itot));
+        input->set_item("grid", "jtot", "", to_string(jtot));
+        input->set_item("grid", "ktot", "", to_string(ktot));
+        input->set_item("grid", "xsize", "", to_string(100.*itot));
+        input->set_item("grid", "ysize", "", to_string(100.*jtot));
+        input->set_item("grid", "zsize", "", to_string(zsize));
+        input->set_item("grid", "swspatialorder", "", c.swspatialorder);
+
+        input->set_item("advec", "swadvec", "", c.swadvec);
+        input->set_item("diff" , "swdiff" , "", c.swdiff );
+        input->set_item("pres" , "swpres" , "", c.swpres );
+
+        const std::string thvar = (c.swthermo == "moist") ? "thl" : "th";
+
+        input->set_item("thermo", "swthermo", "", c.swthermo);
+        if (c.swthermo == "moist")
+        {
+            input->set_item("thermo", "swbasestate", "", "anelastic");
+            input->set_item("thermo", "pbot", "", "101500.");
+            input->set_item("thermo", "swupdatebasestate", "", "0");
+        }
+        else
+        {
+            input->set_item("thermo", "swbasestate", "", "boussinesq");
+            input->set_item("thermo", "thref0", "", "300.");
+        }
+
+        input->set_item("boundary", "swboundary", "", c.swboundary);
+        input->set_item("boundary", "mbctop", "", "freeslip");
+        input->set_item("boundary", "sbcbot", "", "flux");
+        input->set_item("boundary", "sbctop", "", "neumann");
+        input->set_item("boundary", "sbot", thvar, "8.e-3");
+        input->set_item("boundary", "stop", thvar, "0.00365");
+        input->set_item("boundary", "sbot", "qt" , "5.2e-5");
+        input->set_item("boundary", "stop", "qt" , "1.2e-6");
+        if (c.swboundary == "surface")
+        {
+            input->set_item("boundary", "mbcbot", "", "ustar");
+            input->set_item("boundary", "ustar", "", "0.28");
+            input->set_item("boundary", "z0m", "", "0.1");
+            input->set_item("boundary", "z0h", "", "0.1");
+        }
+        else
+            input->set_item("boundary", "mbcbot", "", "noslip");
+
+        input->set_item("fields", "visc" , "", "1.e-5");
+        input->set_item("fields", "svisc", "", "1.e-5");
+        input->set_item("fields", "rndseed", "", "2");
+        input->set_item("fields", "rndamp", "u"  , "0.5");
+        input->set_item("fields", "rndamp", "v"  , "0.5");
+        input->set_item("fields", "rndamp", "w"  , "0.5");
+        input->set_item("fields", "rndamp", thvar, "0.1");
+        input->set_item("fields", "rndamp", "qt" , "1.e-3");
+        input->set_item("fields", "rndz"  , "", to_string(zsize));
+        input->set_item("fields", "rndexp", "", "0.");
+
+        input->set_item("time", "endtime" , "", "1.");
+        input->set_item("time", "savetime", "", "1.");
+
+        // The profiles follow the BOMEX case, a saturated layer is reached within the domain.
+        std::vector<double> z(ktot), u(ktot), v(ktot, 0.), thl(ktot), qt(ktot);
+        const double dz = zsize / ktot;
+        for (int k=0; k<ktot; ++k)
+        {
+            z[k] = (k+0.5)*dz;
+            u[k] = -8.75 + 1.8e-3*z[k];
+            if (z[k] < 520.)
+            {
+                thl[k] = 298.7;
+                qt [k] = 17.0e-3 - z[k]*(17.0e-3-16.3e-3)/520.;
+            }
+            else
+            {
+                thl[k] = 298.7 + (z[k]-520.)*3.85e-3;
+                qt [k] = std::max(16.3e-3 - (z[k]-520.)*(16.3e-3-10.7e-3)/960., 1.e-3);
+            }
+        }
+
+        input->set_prof("z"  , z  );
+        input->set_prof("u"  , u  );
+        input->set_prof("v"  , v  );
+        input->set_prof(thvar, thl);
+        input->set_prof("qt" , qt );
+    }
+
+    // Initialize the model from memory, in the order of Model::save and Model::load.
+    void create_model(Model* model)
+    {
+        model->grid  ->create(model->input);
+        model->grid  ->create_fft_plans();
+        model->fields->create(model->input);
+
+        model->boundary->create(model->input);
+        model->thermo  ->create(model->input);
+
+        model->boundary->set_values();
+        model->diff    ->set_values();
+        model->pres    ->set_values();
+
+        model->boundary->exec();
+        model->fields  ->exec();
+    }
+
+    // Time niter calls of the kernel after one warm-up call and print the throughput.
+    // The bandwidth counts nfields compulsory reads or writes of a 3d field per call.
+    template<class Kernel>
+    void time_kernel(Master* master, std::set<std::string>& done, const std::string& name,
+                     Kernel kernel, const int niter, const double ncells, const double nfields)
+    {
+        if (!done.insert(name).second)
+            return;
+
+        kernel();
+
+        const double start = master->get_wall_clock_time();
+        for (int n=0; n<niter; ++n)
+            kernel();
+        const double time = (master->get_wall_clock_time() - start) / niter;
+
+        master->print_message("%-16s %8d %12.4E %12.4E %10.3f\n",
+                              name.c_str(), niter, time, ncells/time, nfields*ncells*sizeof(double)/time*1.e-9);
+    }
+
+    void run_case(Master* master, std::set<std::string>& done, const Bench_case& c,
+                  const int itot, const int jtot, const int ktot, const int niter)
+    {
+        // The configuration of the case is printed in the header of its table, instead of the echo of the input.
+        Input input(master, false);
+        input.set_quiet(true);
+        set_input(&input, c, itot, jtot, ktot);
+
+        Model model(master, &input);
+        model.init();
+        create_model(&model);
+
+        Grid*   grid   = model.grid;
+        Fields* fields = model.fields;
+        Stats*  stats  = model.stats;
+
+        master->print_message("Benchmark of swspatialorder=%s swadvec=%s swdiff=%s swpres=%s on %dx%dx%d\n",
+                              c.swspatialorder.c_str(), c.swadvec.c_str(), c.swdiff.c_str(), c.swpres.c_str(),
+                              itot, jtot, ktot);
+        master->print_message("%-16s %8s %12s %12s %10s\n", "KERNEL", "NITER", "TIME", "CELLS/S", "GB/S");
+
+        const double ncells = (double)grid->itot*grid->jtot*grid->ktot;
+        const double nprog  = 3 + fields->sp.size();
+
+        // The tendencies accumulate over the repetitions, which does not affect the timings.
+        time_kernel(master, done, "advec_" + c.swadvec, [&]{ model.advec->exec(); },
+                    niter, ncells, 3.*nprog);
+
+        // The viscosity is part of the diffusion, as the exchange of its ghost cells completes in exec().
+        time_kernel(master, done, "diff_" + c.swdiff, [&]{ model.diff->exec_viscosity(); model.diff->exec(); },
+                    niter, ncells, 3.*nprog + ((c.swdiff == "smag2") ? 5. : 0.));
+
+        time_kernel(master, done, "pres_" + c.swpres, [&]{ model.pres->exec(1.); },
+                    niter, ncells, 13.);
+
+        Field3d* tmp1 = fields->atmp["tmp1"];
+        Field3d* tmp2 = fields->atmp["tmp2"];
+        if (c.swthermo == "moist")
+            time_kernel(master, done, "thermo_ql", [&]{ model.thermo->get_thermo_field(tmp1, tmp2, "ql", false); },
+                        niter, ncells, 3.);
+
+        // The statistics are computed for the potential temperature with the default mask that covers the whole domain.
+        Field3d* mask  = fields->atmp["tmp3"];
+        Field3d* maskh = fields->atmp["tmp4"];
+        stats->get_mask(mask, maskh, &stats->masks["default"]);
+        stats->add_active_mask(&stats->masks["default"], mask, maskh);
+
+        const int sloc[] = {0,0,0};
+        const int wloc[] = {0,0,1};
+
+        Field3d* th = fields->sp[(c.swthermo == "moist") ? "thl" : "th"];
+        double* s = th->data;
+        double* w = fields->w->data;
+        const double visc = th->visc;
+
+        std::vector<double> smean(grid->kcells), wmean(grid->kcells), prof(grid->kcells);
+        std::vector<double> prof2(grid->kcells), prof3(grid->kcells), prof4(grid->kcells);
+        const Mask_data smeans(1, smean.data());
+        const Mask_data wmeans(1, wmean.data());
+        const Mask_data profs (1, prof.data());
+        const Mask_data profs2(1, prof2.data());
+        const Mask_data profs3(1, prof3.data());
+        const Mask_data profs4(1, prof4.data());
+        stats->calc_mean(smeans, s, 0., sloc);
+        stats->calc_mean(wmeans, w, 0., wloc);
+
+        time_kernel(master, done, "stats_mean",
+                    [&]{ stats->calc_mean(profs, s, 0., sloc); },
+                    niter, ncells, 2.);
+        // The mean and the moments are computed in the single pass that Fields::exec_stats uses.
+        time_kernel(master, done, "stats_moments",
+                    [&]{ stats->calc_moments(profs, profs2, profs3, profs4, s, 0., sloc); },
+                    niter, ncells, 2.);
+
+        if (c.swspatialorder == "2")
+        {
+            time_kernel(master, done, "stats_grad_2nd",
+                        [&]{ stats->calc_grad_2nd(s, profs, grid->dzhi, sloc); },
+                        niter, ncells, 2.);
+            time_kernel(master, done, "stats_flux_2nd",
+                        [&]{ stats->calc_flux_2nd(s, smeans, w, wmeans, profs, tmp1->data, sloc); },
+                        niter, ncells, 4.);
+            time_kernel(master, done, "stats_diff_2nd",
+                        [&]{ stats->calc_diff_2nd(s, profs, grid->dzhi, visc, sloc); },
+                        niter, ncells, 2.);
+        }
+        else
+        {
+            time_kernel(master, done, "stats_grad_4th",
+                        [&]{ stats->calc_grad_4th(s, profs, grid->dzhi4, sloc); },
+                        niter, ncells, 2.);
+            time_kernel(master, done, "stats_flux_4th",
+                        [&]{ stats->calc_flux_4th(s, w, profs, tmp1->data, sloc); },
+                        niter, ncells, 4.);
+            time_kernel(master, done, "stats_diff_4th",
+                        [&]{ stats->calc_diff_4th(s, profs, grid->dzhi4, visc, sloc); },
+                        niter, ncells, 2.);
+        }
+
+        stats->clear_active_masks();
+    }
+}
+
+// Benchmark of the computational kernels on a synthetic grid, without input files.
+// Usage: microhh_bench [itot jtot ktot [niter]]
+int main(int argc, char *argv[])
+{
+    Master master;
+    try
+    {
+        int itot  = 64;
+        int jtot  = 64;
+        int ktot  = 64;
+        int niter = 10;
+
+        if (argc == 4 || argc == 5)
+        {
+            itot = std::atoi(argv[1]);
+            jtot = std::atoi(argv[2]);
+            ktot = std::atoi(argv[3]);
+            if (argc == 5)
+                niter = std::atoi(argv[4]);
+        }
+        else if (argc != 1)
+        {
+            std::printf("Usage: %s [itot jtot ktot [niter]]\n", argv[0]);
+            return 1;
+        }
+
+        // Start the master class in init mode, which requires no data on disk.
+        char mode[] = "init";
+        char simname[] = "microhh_bench";
+        char* masterargv[] = {argv[0], mode, simname};
+        master.start(3, masterargv);
+
+        master.print_message("Microhh git-hash: " GITHASH "\n");
+
+        Input masterinput(&master, false);
+        master.init(&masterinput);
+
+        // Kernels that are shared by multiple configurations are timed only once.
+        std::set<std::string> done;
+        for (const Bench_case& c : bench_cases)
+            run_case(&master, done, c, itot, jtot, ktot, niter);
+    }
+
+    // Catch any exceptions and return 1.
+    catch (...)
+    {
+        return 1;
+    }
+
+    return 0;
+}
@@ -82,6 +82,7 @@ double Advec_2::calc_cfl(double* restrict u, double* restrict v, double* restric
 
     double cfl = 0;
 
+#pragma omp parallel for reduction(max:cfl)
     for (int k=grid->kstart; k<grid->kend; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
 #pragma ivdep
@@ -108,6 +109,7 @@ void Advec_2::advec_u(double* restrict ut, double* restrict u, double* restrict
     const double dxi = 1./grid->dx;
     const double dyi = 1./grid->dy;
 
+#pragma omp parallel for
     for (int k=grid->kstart; k<grid->kend; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
 #pragma ivdep
@@ -136,6 +138,7 @@ void Advec_2::advec_v(double* restrict vt, double* restrict u, double* restrict
     const double dxi = 1./grid->dx;
     const double dyi = 1./grid->dy;
 
+#pragma omp parallel for
     for (int k=grid->kstart; k<grid->kend; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
 #pragma ivdep
@@ -164,6 +167,7 @@ void Advec_2::advec_w(double* restrict wt, double* restrict u, double* restrict
     const double dxi = 1./grid->dx;
     const double dyi = 1./grid->dy;
 
+#pragma omp parallel for
     for (int k=grid->kstart+1; k<grid->kend; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
 #pragma ivdep
@@ -192,6 +196,7 @@ void Advec_2::advec_s(double* restrict st, double* restrict s, double* restrict
     const double dxi = 1./grid->dx;
     const double dyi = 1./grid->dy;
 
+#pragma omp parallel for
     for (int k=grid->kstart; k<grid->kend; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
 #pragma ivdep
@@ -111,6 +111,7 @@ double Advec_2i4::calc_cfl(double* restrict u, double* restrict v, double* restr
                               + std::abs(interp2(w[ijk    ], w[ijk+kk1]))*dzi[k]);
         }
 
+#pragma omp parallel for reduction(max:cfl)
     for (k=grid->kstart+1; k<grid->kend-1; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
 #pragma ivdep
@@ -196,6 +197,7 @@ void Advec_2i4::advec_u(double* restrict ut, double* restrict u, double* restric
                        - rhorefh[k  ] * interp2(w[ijk-ii1    ], w[ijk    ]) * interp2(u[ijk-kk1], u[ijk    ]) ) / rhoref[k] * dzi[k];
         }
 
+#pragma omp parallel for
     for (k=grid->kstart+2; k<grid->kend-2; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
 #pragma ivdep
@@ -311,6 +313,7 @@ void Advec_2i4::advec_v(double* restrict vt, double* restrict u, double* restric
                        - rhorefh[k  ] * interp2(w[ijk-jj1    ], w[ijk    ]) * interp2(v[ijk-kk1], v[ijk    ]) ) / rhoref[k] * dzi[k];
         }
 
+#pragma omp parallel for
     for (k=grid->kstart+2; k<grid->kend-2; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
 #pragma ivdep
@@ -407,6 +410,7 @@ void Advec_2i4::advec_w(double* restrict wt, double* restrict u, double* restric
                        - rhoref[k-1] * interp2(w[ijk-kk1    ], w[ijk    ]) * interp2(w[ijk-kk1], w[ijk    ]) ) / rhorefh[k] * dzhi[k];
         }
 
+#pragma omp parallel for
     for (k=grid->kstart+2; k<grid->kend-1; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
 #pragma ivdep
@@ -498,6 +502,7 @@ void Advec_2i4::advec_s(double* restrict st, double* restrict s, double* restric
                        - rhorefh[k  ] * w[ijk    ] * interp2(s[ijk-kk1], s[ijk    ]) ) / rhoref[k] * dzi[k];
         }
 
+#pragma omp parallel for
     for (k=grid->kstart+2; k<grid->kend-2; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
 #pragma ivdep
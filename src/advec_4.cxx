@@ -94,6 +94,7 @@ double Advec_4::calc_cfl(double * restrict u, double * restrict v, double * rest
 
     double cfl = 0;
 
+#pragma omp parallel for reduction(max:cfl)
     for (int k=grid->kstart; k<grid->kend; k++)
         for (int j=grid->jstart; j<grid->jend; j++)
 #pragma ivdep
@@ -157,6 +158,7 @@ void Advec_4::advec_u(double * restrict ut, double * restrict u, double * restri
                      * dzi4[kstart];
         }
 
+#pragma omp parallel for
     for (int k=grid->kstart+1; k<grid->kend-1; k++)
         for (int j=grid->jstart; j<grid->jend; j++)
 #pragma ivdep
@@ -255,6 +257,7 @@ void Advec_4::advec_v(double * restrict vt, double * restrict u, double * restri
                      * dzi4[kstart];
         }
 
+#pragma omp parallel for
     for (int k=grid->kstart+1; k<grid->kend-1; k++)
         for (int j=grid->jstart; j<grid->jend; j++)
 #pragma ivdep
@@ -353,6 +356,7 @@ void Advec_4::advec_w(double * restrict wt, double * restrict u, double * restri
                 * dzhi4[kstart+1];
         }
 
+#pragma omp parallel for
     for (int k=grid->kstart+2; k<grid->kend-1; k++)
         for (int j=grid->jstart; j<grid->jend; j++)
 #pragma ivdep
@@ -451,6 +455,7 @@ void Advec_4::advec_s(double * restrict st, double * restrict s, double * restri
                      * dzi4[kstart];
         }
 
+#pragma omp parallel for
     for (int k=grid->kstart+1; k<grid->kend-1; k++)
         for (int j=grid->jstart; j<grid->jend; j++)
 #pragma ivdep
@@ -84,6 +84,7 @@ double Advec_4m::calc_cfl(double * restrict u, double * restrict v, double * res
 
     double cfl = 0;
 
+#pragma omp parallel for reduction(max:cfl)
     for (int k=grid->kstart; k<grid->kend; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
 #pragma ivdep
@@ -145,6 +146,7 @@ void Advec_4m::advec_u(double * restrict ut, double * restrict u, double * restr
                        * dzi4[kstart];
         }
 
+#pragma omp parallel for
     for (int k=grid->kstart+1; k<grid->kend-1; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
 #pragma ivdep
@@ -236,6 +238,7 @@ void Advec_4m::advec_v(double * restrict vt, double * restrict u, double * restr
                        * dzi4[kstart];
         }
 
+#pragma omp parallel for
     for (int k=grid->kstart+1; k<grid->kend-1; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
 #pragma ivdep
@@ -326,6 +329,7 @@ interp4       (w[ijk    ], w[ijk+kk1], w[ijk+kk2], w[ijk+kk3]) * interp4       (
      }
 
 */
+#pragma omp parallel for
     for (int k=grid->kstart+1; k<grid->kend; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
 #pragma ivdep
@@ -419,6 +423,7 @@ void Advec_4m::advec_s(double * restrict st, double * restrict s, double * restr
                        * dzi4[kstart];
         }
 
+#pragma omp parallel for
     for (int k=grid->kstart+1; k<grid->kend-1; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
 #pragma ivdep
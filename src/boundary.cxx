@@ -291,12 +291,12 @@ void Boundary::set_values()
 void Boundary::exec()
 {
     // Cyclic boundary conditions, do this before the bottom BC's
-    grid->boundary_cyclic(fields->u->data);
-    grid->boundary_cyclic(fields->v->data);
-    grid->boundary_cyclic(fields->w->data);
+    // All prognostic fields are exchanged together to save on the number of messages.
+    std::vector<double*> cyclic_fields;
+    for (FieldMap::const_iterator it = fields->ap.begin(); it!=fields->ap.end(); ++it)
+        cyclic_fields.push_back(it->second->data);
 
-    for (FieldMap::const_iterator it = fields->sp.begin(); it!=fields->sp.end(); ++it)
-        grid->boundary_cyclic(it->second->data);
+    grid->boundary_cyclic(cyclic_fields);
 
     // Update the boundary values.
     update_bcs();
@@ -359,7 +359,7 @@ void Boundary::exec_cross()
 {
 }
 
-void Boundary::exec_stats(Mask* m)
+void Boundary::exec_stats()
 {
 }
 
@@ -221,10 +221,10 @@ void Boundary_surface::exec_cross()
         throw 1;
 }
 
-void Boundary_surface::exec_stats(Mask *m)
+void Boundary_surface::exec_stats()
 {
-    stats->calc_mean2d(&m->tseries["obuk"].data , obuk , 0., fields->atmp["tmp4"]->databot, &stats->nmaskbot);
-    stats->calc_mean2d(&m->tseries["ustar"].data, ustar, 0., fields->atmp["tmp4"]->databot, &stats->nmaskbot);
+    stats->calc_mean2d(stats->get_time_series("obuk" ), obuk , 0.);
+    stats->calc_mean2d(stats->get_time_series("ustar"), ustar, 0.);
 }
 
 void Boundary_surface::set_values()
@@ -331,22 +331,25 @@ void Boundary_surface::init_solver()
 #ifndef USECUDA
 void Boundary_surface::update_bcs()
 {
+    Tmp_fields tmp(fields);
+
     // Start with retrieving the stability information.
     if (model->thermo->get_switch() == "0")
     {
         stability_neutral(ustar, obuk,
                           fields->u->data, fields->v->data,
                           fields->u->databot, fields->v->databot,
-                          fields->atmp["tmp1"]->data, grid->z);
+                          tmp.get_slice(grid->ijcells), grid->z);
     }
     else
     {
-        // Store the buoyancy in tmp1.
-        model->thermo->get_buoyancy_surf(fields->atmp["tmp1"]);
-        stability(ustar, obuk, fields->atmp["tmp1"]->datafluxbot,
-                  fields->u->data,    fields->v->data,    fields->atmp["tmp1"]->data,
-                  fields->u->databot, fields->v->databot, fields->atmp["tmp1"]->databot,
-                  fields->atmp["tmp2"]->data, grid->z);
+        // Store the buoyancy in a tmp field.
+        Field3d* b = tmp.get_field(true);
+        model->thermo->get_buoyancy_surf(b);
+        stability(ustar, obuk, b->datafluxbot,
+                  fields->u->data,    fields->v->data,    b->data,
+                  fields->u->databot, fields->v->databot, b->databot,
+                  tmp.get_slice(grid->ijcells), grid->z);
     }
 
     // Calculate the surface value, gradient and flux depending on the chosen boundary condition.
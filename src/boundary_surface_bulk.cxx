@@ -250,19 +250,23 @@ void Boundary_surface_bulk::update_bcs()
 {
     const double zsl = grid->z[grid->kstart];
 
+    Tmp_fields tmp(fields);
+    double* dutot = tmp.get_slice(grid->ijcells);
+
     // Calculate total wind speed difference with surface
-    calculate_du(fields->atmp["tmp1"]->data, fields->u->data, fields->v->data, fields->u->databot, fields->v->databot);
+    calculate_du(dutot, fields->u->data, fields->v->data, fields->u->databot, fields->v->databot);
 
     // Calculate surface momentum fluxes and gradients
     momentum_fluxgrad(fields->u->datafluxbot, fields->v->datafluxbot, fields->u->datagradbot, fields->v->datagradbot,
-                      fields->u->data, fields->v->data, fields->u->databot, fields->v->databot, fields->atmp["tmp1"]->data, bulk_cm, zsl);
+                      fields->u->data, fields->v->data, fields->u->databot, fields->v->databot, dutot, bulk_cm, zsl);
 
     // Calculate surface scalar fluxes and gradients
     for (FieldMap::const_iterator it=fields->sp.begin(); it!=fields->sp.end(); ++it)
-        scalar_fluxgrad(it->second->datafluxbot, it->second->datagradbot, it->second->data, it->second->databot, fields->atmp["tmp1"]->data, bulk_cs[it->first], zsl);
+        scalar_fluxgrad(it->second->datafluxbot, it->second->datagradbot, it->second->data, it->second->databot, dutot, bulk_cs[it->first], zsl);
     
     // Calculate Obukhov length and ustar
-    model->thermo->get_buoyancy_fluxbot(fields->atmp["tmp2"]);
-    surface_scaling(ustar, obuk, fields->atmp["tmp1"]->data, fields->atmp["tmp2"]->datafluxbot, bulk_cm); 
+    Field3d* b = tmp.get_field(true);
+    model->thermo->get_buoyancy_fluxbot(b);
+    surface_scaling(ustar, obuk, dutot, b->datafluxbot, bulk_cm); 
 }
 //#endif
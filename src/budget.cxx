@@ -20,6 +20,7 @@
  * along with MicroHH.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include "input.h"
 #include "master.h"
 #include "grid.h"
@@ -71,3 +72,28 @@ Budget* Budget::factory(Input* inputin, Master* masterin, Grid* gridin, Fields*
         throw 1;
     }
 }
+
+void Budget::add_prof(std::string name, std::string longname, std::string unit, std::string zloc)
+{
+    stats.add_prof(name, longname, unit, zloc);
+    prof_names.push_back(name);
+}
+
+/**
+ * The budgets do not depend on the mask. They are calculated once for the first active mask,
+ * and their profiles are copied to the other active masks.
+ */
+void Budget::exec_stats_masks()
+{
+    if (stats.get_nmasks() == 0)
+        return;
+
+    exec_stats(stats.get_active_mask(0));
+
+    for (std::vector<std::string>::const_iterator it=prof_names.begin(); it!=prof_names.end(); ++it)
+    {
+        const Mask_data data = stats.get_profs(*it);
+        for (int n=1; n<stats.get_nmasks(); ++n)
+            std::copy(data[0], data[0]+grid.kcells, data[n]);
+    }
+}
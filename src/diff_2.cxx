@@ -82,6 +82,7 @@ void Diff_2::diff_c(double* restrict at, double* restrict a, double* restrict dz
     const double dxidxi = 1./(grid->dx * grid->dx);
     const double dyidyi = 1./(grid->dy * grid->dy);
 
+#pragma omp parallel for
     for (int k=grid->kstart; k<grid->kend; k++)
         for (int j=grid->jstart; j<grid->jend; j++)
 #pragma ivdep
@@ -107,6 +108,7 @@ void Diff_2::diff_w(double* restrict wt, double* restrict w, double* restrict dz
     const double dxidxi = 1./(grid->dx*grid->dx);
     const double dyidyi = 1./(grid->dy*grid->dy);
 
+#pragma omp parallel for
     for (int k=grid->kstart+1; k<grid->kend; k++)
         for (int j=grid->jstart; j<grid->jend; j++)
 #pragma ivdep
@@ -124,6 +124,7 @@ void Diff_4::diff_c(double* restrict at, double* restrict a, double* restrict dz
                             * dzi4[kstart];
         }
 
+#pragma omp parallel for
     for (int k=grid->kstart+1; k<grid->kend-1; k++)
         for (int j=grid->jstart; j<grid->jend; j++)
 #pragma ivdep
@@ -192,6 +193,7 @@ void Diff_4::diff_w(double* restrict at, double* restrict a, double* restrict dz
                             * dzhi4[kstart+1];
         }
 
+#pragma omp parallel for
     for (int k=grid->kstart+2; k<grid->kend-1; k++)
         for (int j=grid->jstart; j<grid->jend; j++)
 #pragma ivdep
@@ -127,25 +127,35 @@ void Diff_smag_2::exec_viscosity()
     // assume buoyancy calculation is needed
     else
     {
-        // store the buoyancyflux in tmp1
-        model->thermo->get_buoyancy_fluxbot(fields->atmp["tmp1"]);
-        // retrieve the full field in tmp1 and use tmp2 for temporary calculations
-        model->thermo->get_thermo_field(fields->atmp["tmp1"], fields->atmp["tmp2"], "N2", false);
+        Tmp_fields tmp(fields);
+        Field3d* n2 = tmp.get_field(true);
+
+        // store the buoyancyflux in n2
+        model->thermo->get_buoyancy_fluxbot(n2);
+        // retrieve the full field in n2 and use a second tmp field for temporary calculations
+        model->thermo->get_thermo_field(n2, tmp.get_field(), "N2", false);
         // model->thermo->getThermoField(fields->sd["tmp1"], fields->sd["tmp2"], "b");
 
         calc_evisc(fields->sd["evisc"]->data,
-                   fields->u->data, fields->v->data, fields->w->data, fields->atmp["tmp1"]->data,
-                   fields->u->datafluxbot, fields->v->datafluxbot, fields->atmp["tmp1"]->datafluxbot,
+                   fields->u->data, fields->v->data, fields->w->data, n2->data,
+                   fields->u->datafluxbot, fields->v->datafluxbot, n2->datafluxbot,
                    boundaryptr->ustar, boundaryptr->obuk,
                    grid->z, grid->dz, grid->dzi,
                    boundaryptr->z0m);
     }
+
+    // Start the exchange of the ghost cells of the viscosity, which are only needed in exec(),
+    // such that the advection is computed while the messages are in flight.
+    grid->boundary_cyclic_start(fields->sd["evisc"]->data);
 }
 #endif
 
 #ifndef USECUDA
 void Diff_smag_2::exec()
 {
+    // Complete the exchange of the viscosity ghost cells started in exec_viscosity().
+    grid->boundary_cyclic_finish(fields->sd["evisc"]->data);
+
     if(model->boundary->get_switch() == "surface")
     {
         diff_u<false>(fields->ut->data, fields->u->data, fields->v->data, fields->w->data, grid->dzi, grid->dzhi, fields->sd["evisc"]->data,
@@ -161,6 +171,10 @@ void Diff_smag_2::exec()
     }
     else
     {
+        // The neutral viscosity with resolved walls needs the ghost cells at the walls.
+        if (model->thermo->get_switch() == "0")
+            calc_evisc_wall(fields->sd["evisc"]->data, fields->visc);
+
         diff_u<true>(fields->ut->data, fields->u->data, fields->v->data, fields->w->data, grid->dzi, grid->dzhi, fields->sd["evisc"]->data,
                fields->u->datafluxbot, fields->u->datafluxtop, fields->rhoref, fields->rhorefh);
         diff_v<true>(fields->vt->data, fields->u->data, fields->v->data, fields->w->data, grid->dzi, grid->dzhi, fields->sd["evisc"]->data,
@@ -242,6 +256,7 @@ void Diff_smag_2::calc_strain2(double* restrict strain2,
             }
     }
 
+    #pragma omp parallel for
     for (int k=grid->kstart+k_offset; k<grid->kend; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
             #pragma ivdep
@@ -324,6 +339,7 @@ void Diff_smag_2::calc_evisc(double* restrict evisc,
             evisc[ijk] = fac * std::sqrt(evisc[ijk]) * std::sqrt(1.-RitPrratio);
         }
 
+    #pragma omp parallel for private(mlen0, mlen, fac, RitPrratio)
     for (int k=grid->kstart+1; k<grid->kend; ++k)
     {
         // calculate smagorinsky constant times filter width squared, use wall damping according to Mason
@@ -342,8 +358,6 @@ void Diff_smag_2::calc_evisc(double* restrict evisc,
                 evisc[ijk] = fac * std::sqrt(evisc[ijk]) * std::sqrt(1.-RitPrratio);
             }
     }
-
-    grid->boundary_cyclic(evisc);
 }
 
 template <bool resolved_wall>
@@ -365,6 +379,7 @@ void Diff_smag_2::calc_evisc_neutral(double* restrict evisc,
 
     if (resolved_wall)
     {
+        #pragma omp parallel for
         for (int k=grid->kstart; k<grid->kend; ++k)
         {
             const double mlen = pow(cs*std::pow(dx*dy*dz[k], 1./3.), 2);
@@ -377,24 +392,11 @@ void Diff_smag_2::calc_evisc_neutral(double* restrict evisc,
                 }
         }
 
-        grid->boundary_cyclic(evisc);
-
-        // For a resolved wall the viscosity at the wall is needed. For now, assume that the eddy viscosity
-        // is zero, so set ghost cell such that the viscosity interpolated to the surface equals the molecular viscosity.
-        const int kb = grid->kstart;
-        const int kt = grid->kend-1;
-        for (int j=0; j<grid->jcells; ++j)
-            #pragma ivdep
-            for (int i=0; i<grid->icells; ++i)
-            {
-                const int ijkb = i + j*jj + kb*kk;
-                const int ijkt = i + j*jj + kt*kk;
-                evisc[ijkb-kk] = 2 * mvisc - evisc[ijkb];
-                evisc[ijkt+kk] = 2 * mvisc - evisc[ijkt];
-            }
+        // The ghost cells at the walls are set in calc_evisc_wall() once the cyclic boundaries are filled.
     }
     else
     {
+        #pragma omp parallel for
         for (int k=grid->kstart; k<grid->kend; ++k)
         {
             // Calculate smagorinsky constant times filter width squared, use wall damping according to Mason's paper.
@@ -410,12 +412,30 @@ void Diff_smag_2::calc_evisc_neutral(double* restrict evisc,
                     evisc[ijk] = fac * std::sqrt(evisc[ijk]);
                 }
         }
-
-        grid->boundary_cyclic(evisc);
     }
 
 }
 
+void Diff_smag_2::calc_evisc_wall(double* restrict evisc, const double mvisc)
+{
+    const int jj = grid->icells;
+    const int kk = grid->ijcells;
+
+    // For a resolved wall the viscosity at the wall is needed. For now, assume that the eddy viscosity
+    // is zero, so set ghost cell such that the viscosity interpolated to the surface equals the molecular viscosity.
+    const int kb = grid->kstart;
+    const int kt = grid->kend-1;
+    for (int j=0; j<grid->jcells; ++j)
+        #pragma ivdep
+        for (int i=0; i<grid->icells; ++i)
+        {
+            const int ijkb = i + j*jj + kb*kk;
+            const int ijkt = i + j*jj + kt*kk;
+            evisc[ijkb-kk] = 2 * mvisc - evisc[ijkb];
+            evisc[ijkt+kk] = 2 * mvisc - evisc[ijkt];
+        }
+}
+
 template <bool resolved_wall>
 void Diff_smag_2::diff_u(double* restrict ut, double* restrict u, double* restrict v, double* restrict w,
                          double* restrict dzi, double* restrict dzhi, double* restrict evisc,
@@ -485,6 +505,7 @@ void Diff_smag_2::diff_u(double* restrict ut, double* restrict u, double* restri
             }
     }
 
+    #pragma omp parallel for private(eviscn, eviscs, eviscb, evisct)
     for (int k=grid->kstart+k_offset; k<grid->kend-k_offset; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
             #pragma ivdep
@@ -576,6 +597,7 @@ void Diff_smag_2::diff_v(double* restrict vt, double* restrict u, double* restri
             }
     }
 
+    #pragma omp parallel for private(evisce, eviscw, eviscb, evisct)
     for (int k=grid->kstart+k_offset; k<grid->kend-k_offset; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
             #pragma ivdep
@@ -612,6 +634,7 @@ void Diff_smag_2::diff_w(double* restrict wt, double* restrict u, double* restri
 
     double evisce, eviscw, eviscn, eviscs;
 
+    #pragma omp parallel for private(evisce, eviscw, eviscn, eviscs)
     for (int k=grid->kstart+1; k<grid->kend; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
             #pragma ivdep
@@ -674,6 +697,7 @@ void Diff_smag_2::diff_c(double* restrict at, double* restrict a,
                        + rhorefh[kstart  ] * fluxbot[ij] ) / rhoref[kstart] * dzi[kstart];
         }
 
+    #pragma omp parallel for private(evisce, eviscw, eviscn, eviscs, evisct, eviscb)
     for (int k=grid->kstart+1; k<grid->kend-1; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
             #pragma ivdep
@@ -732,6 +756,7 @@ double Diff_smag_2::calc_dnmul(double* restrict evisc, double* restrict dzi, dou
     double dnmul = 0;
 
     // get the maximum time step for diffusion
+    #pragma omp parallel for reduction(max:dnmul)
     for (int k=grid->kstart; k<grid->kend; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
             #pragma ivdep
@@ -58,60 +58,72 @@ Field3d::Field3d(Grid* gridin, Master* masterin, std::string namein, std::string
 }
 
 #ifndef USECUDA
+namespace
+{
+    // Round the size of an array up to a multiple of 64 bytes, such that the next array is aligned.
+    inline long align_size(const long n)
+    {
+        const long nalign = 64/sizeof(double);
+        return (n + nalign - 1) / nalign * nalign;
+    }
+}
+
 Field3d::~Field3d()
 {
-    delete[] data;
-    delete[] databot;
-    delete[] datatop;
-    delete[] datamean;
-    delete[] datagradbot;
-    delete[] datagradtop;
-    delete[] datafluxbot;
-    delete[] datafluxtop;
+    // The memory of the arrays belongs to the block that is owned by Fields.
 }
 
-int Field3d::init()
+long Field3d::memory_size(Grid* grid, const bool with2d)
 {
-    // Calculate the total field memory size
-    const long fieldMemorySize = (grid->ncells + 6*grid->ijcells + grid->kcells)*sizeof(double);
+    return align_size(grid->ncells) + (with2d ? 6*align_size(grid->ijcells) : 0) + align_size(grid->kcells);
+}
 
-    // Keep track of the total memory in fields
-    static long totalMemorySize = 0;
-    try
-    {
-        totalMemorySize += fieldMemorySize;
-        // Allocate all fields belonging to the 3d field
-        data = new double[grid->ncells];
-        databot = new double[grid->ijcells];
-        datatop = new double[grid->ijcells];
-        datamean = new double[grid->kcells];
-        datagradbot = new double[grid->ijcells];
-        datagradtop = new double[grid->ijcells];
-        datafluxbot = new double[grid->ijcells];
-        datafluxtop = new double[grid->ijcells];
-    }
-    catch (std::exception &e)
+int Field3d::init(double* mem, const bool with2d)
+{
+    // Assign all fields belonging to the 3d field to consecutive aligned parts of the block
+    data     = mem; mem += align_size(grid->ncells);
+    datamean = mem; mem += align_size(grid->kcells);
+
+    // Fields without boundaries keep the 2d arrays at 0, such that any use fails immediately
+    if (with2d)
     {
-        master->print_error("Field %s cannot be allocated, total fields memsize %lu is too large\n", name.c_str(), totalMemorySize);
-        throw;
+        databot     = mem; mem += align_size(grid->ijcells);
+        datatop     = mem; mem += align_size(grid->ijcells);
+        datagradbot = mem; mem += align_size(grid->ijcells);
+        datagradtop = mem; mem += align_size(grid->ijcells);
+        datafluxbot = mem; mem += align_size(grid->ijcells);
+        datafluxtop = mem;
     }
 
-    // set all values to zero
-    for (int n=0; n<grid->ncells; ++n)
+    // Set all values to zero. The interior levels are zeroed in the same decomposition over
+    // the threads as the kernels, such that the memory pages are placed at the NUMA node of
+    // the thread that uses them, as pages are placed at the first touch.
+    const int kk = grid->ijcells;
+
+    for (int n=0; n<grid->kstart*kk; ++n)
+        data[n] = 0.;
+
+#pragma omp parallel for
+    for (int k=grid->kstart; k<grid->kend; ++k)
+        for (int n=k*kk; n<(k+1)*kk; ++n)
+            data[n] = 0.;
+
+    for (int n=grid->kend*kk; n<grid->ncells; ++n)
         data[n] = 0.;
 
     for (int n=0; n<grid->kcells; ++n)
         datamean[n] = 0.;
 
-    for (int n=0; n<grid->ijcells; ++n)
-    {
-        databot    [n] = 0.;
-        datatop    [n] = 0.;
-        datagradbot[n] = 0.;
-        datagradtop[n] = 0.;
-        datafluxbot[n] = 0.;
-        datafluxtop[n] = 0.;
-    }
+    if (with2d)
+        for (int n=0; n<grid->ijcells; ++n)
+        {
+            databot    [n] = 0.;
+            datatop    [n] = 0.;
+            datagradbot[n] = 0.;
+            datagradtop[n] = 0.;
+            datafluxbot[n] = 0.;
+            datafluxtop[n] = 0.;
+        }
 
     return 0;
 }
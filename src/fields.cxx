@@ -47,8 +47,8 @@ Fields::Fields(Model *modelin, Input *inputin)
     // Initialize the pointers.
     rhoref  = 0;
     rhorefh = 0;
-    umodel  = 0;
-    vmodel  = 0;
+
+    field_memory = 0;
 
     // Initialize GPU pointers
     rhoref_g  = 0;
@@ -84,6 +84,10 @@ Fields::Fields(Model *modelin, Input *inputin)
     // before the init phase, where they are initialized in Fields::init()
     n_tmp_fields = 4;
 
+    // The default tmp fields have the 2d arrays of the boundaries, as they are used for surface
+    // quantities and masks. Classes that need them in more tmp fields can increase this number.
+    n_tmp_fields_2d = 4;
+
     // Remove the data from the input that is not used in run mode, to avoid warnings.
     if (master->mode == "run")
     {
@@ -128,8 +132,11 @@ Fields::~Fields()
     // delete the arrays
     delete[] rhoref;
     delete[] rhorefh;
-    delete[] umodel;
-    delete[] vmodel;
+
+#ifndef USECUDA
+    // deallocate the memory of all fields
+    std::free(field_memory);
+#endif
 
 #ifdef USECUDA
     clear_device();
@@ -143,26 +150,11 @@ void Fields::init()
 
     int nerror = 0;
 
-    // ALLOCATE ALL THE FIELDS
-    // allocate the prognostic velocity fields
-    for (FieldMap::iterator it=mp.begin(); it!=mp.end(); ++it)
-        nerror += it->second->init();
-
-    // allocate the velocity tendency fields
-    for (FieldMap::iterator it=mt.begin(); it!=mt.end(); ++it)
-        nerror += it->second->init();
-
-    // allocate the prognostic scalar fields
-    for (FieldMap::iterator it=sp.begin(); it!=sp.end(); ++it)
-        nerror += it->second->init();
-
-    // allocate the scalar tendency fields
-    for (FieldMap::iterator it=st.begin(); it!=st.end(); ++it)
-        nerror += it->second->init();
-
-    // allocate the diagnostic scalars
-    for (FieldMap::iterator it=sd.begin(); it!=sd.end(); ++it)
-        nerror += it->second->init();
+    // The number of tmp fields that hold the xz slices is known now that the grid is initialized.
+    // The slices are packed into the fields in the same way as in Tmp_fields::get_slice.
+    const int nxz = grid->ncells / Tmp_fields::get_slice_size(grid->icells*grid->kcells);
+    for (std::vector<std::pair<int, int> >::const_iterator it=n_tmp_fields_xz.begin(); it!=n_tmp_fields_xz.end(); ++it)
+        n_tmp_fields = std::max(n_tmp_fields, it->first + (it->second + nxz - 1) / nxz);
 
     // now that all classes have been able to set the minimum number of tmp fields, initialize them
     for (int i=1; i<=n_tmp_fields; ++i)
@@ -173,9 +165,58 @@ void Fields::init()
         init_tmp_field(name, "", "");
     }
 
-    // allocate the tmp fields
-    for (FieldMap::iterator it=atmp.begin(); it!=atmp.end(); ++it)
-        nerror += it->second->init();
+    // ALLOCATE ALL THE FIELDS
+    // Collect all fields and whether they need the 2d arrays of the boundaries. The prognostic fields
+    // need them for their boundary conditions and the first tmp fields are used to compute surface
+    // quantities and masks. The tendencies, the diagnostic scalars and the other tmp fields only
+    // use their 3d data and mean profile, which saves the memory of six 2d arrays per field.
+    std::vector<Field3d*> fieldlist;
+    std::vector<bool> with2d;
+    const FieldMap* fieldmaps[] = {&mp, &mt, &sp, &st, &sd};
+    const bool fieldmaps2d[] = {true, false, true, false, false};
+    for (int m=0; m<5; ++m)
+        for (FieldMap::const_iterator it=fieldmaps[m]->begin(); it!=fieldmaps[m]->end(); ++it)
+        {
+            fieldlist.push_back(it->second);
+            with2d.push_back(fieldmaps2d[m]);
+        }
+
+    for (int i=1; i<=n_tmp_fields; ++i)
+    {
+        std::string name = "tmp" + std::to_string(static_cast<long long>(i));
+        fieldlist.push_back(atmp[name]);
+        with2d.push_back(i <= n_tmp_fields_2d);
+    }
+
+#ifndef USECUDA
+    // Allocate all fields in a single block of memory aligned at 64 bytes, the arrays within
+    // the fields are aligned as well, such that the rows are aligned if icells is padded.
+    long memsize = 0;
+    for (size_t n=0; n<fieldlist.size(); ++n)
+        memsize += Field3d::memory_size(grid, with2d[n])*sizeof(double);
+
+    void* mem = 0;
+    if (posix_memalign(&mem, 64, memsize) != 0)
+    {
+        master->print_error("Fields cannot be allocated, total fields memsize %ld is too large\n", memsize);
+        throw 1;
+    }
+    field_memory = static_cast<double*>(mem);
+
+    double* fieldmem = field_memory;
+    for (size_t n=0; n<fieldlist.size(); ++n)
+    {
+        nerror += fieldlist[n]->init(fieldmem, with2d[n]);
+        fieldmem += Field3d::memory_size(grid, with2d[n]);
+    }
+#else
+    for (size_t n=0; n<fieldlist.size(); ++n)
+        nerror += fieldlist[n]->init();
+#endif
+
+    // all tmp fields are available for borrowing
+    for (int i=1; i<=n_tmp_fields; ++i)
+        tmp_pool.push_back(atmp["tmp" + std::to_string(static_cast<long long>(i))]);
 
     if (nerror > 0)
         throw 1;
@@ -192,17 +233,6 @@ void Fields::init()
         rhorefh[k] = 1.; 
     }
 
-    // allocate help arrays for statistics;
-    umodel = new double[grid->kcells];
-    vmodel = new double[grid->kcells];
-
-    // Initialize at zero
-    for (int k=0; k<grid->kcells; ++k)
-    {
-        umodel[k] = 0.;
-        vmodel[k] = 0.; 
-    }
-
     // Get global cross-list from cross.cxx
     std::vector<std::string> *crosslist_global = model->cross->get_crosslist(); 
 
@@ -395,7 +425,7 @@ void Fields::calc_mask_wmin(double* restrict mask, double* restrict maskh, doubl
     *nmaskbot = nmaskh[grid->kstart];
 }
 
-void Fields::exec_stats(Mask *m)
+void Fields::exec_stats()
 {
     // define locations
     const int uloc[] = {1,0,0};
@@ -403,179 +433,132 @@ void Fields::exec_stats(Mask *m)
     const int wloc[] = {0,0,1};
     const int sloc[] = {0,0,0};
 
-    const int uwloc[] = {1,0,1};
-    const int vwloc[] = {0,1,1};
-
     const double NoOffset = 0.;
 
-    // save the area coverage of the mask
-    stats->calc_area(m->profs["area" ].data, sloc, stats->nmask );
-    stats->calc_area(m->profs["areah"].data, wloc, stats->nmaskh);
+    // the mean velocities of the model, per mask
+    const int nmasks = stats->get_nmasks();
+    umodel.resize(nmasks*grid->kcells);
+    vmodel.resize(nmasks*grid->kcells);
 
-    // start with the stats on the w location, to make the wmean known for the flux calculations
-    stats->calc_mean(m->profs["w"].data, w->data, NoOffset, wloc, atmp["tmp4"]->data, stats->nmaskh);
-    for (int n=2; n<5; ++n)
+    Mask_data um(nmasks);
+    Mask_data vm(nmasks);
+    for (int n=0; n<nmasks; ++n)
     {
-        std::stringstream ss;
-        ss << n;
-        std::string sn = ss.str();
-        stats->calc_moment(w->data, m->profs["w"].data, m->profs["w"+sn].data, n, wloc,
-                          atmp["tmp4"]->data, stats->nmaskh);
+        um[n] = &umodel[n*grid->kcells];
+        vm[n] = &vmodel[n*grid->kcells];
     }
 
-    // calculate the stats on the u location
-    // interpolate the mask horizontally onto the u coordinate
-    grid->interpolate_2nd(atmp["tmp1"]->data, atmp["tmp3"]->data, sloc, uloc);
-    stats->calc_mean(m->profs["u"].data, u->data, grid->utrans, uloc, atmp["tmp1"]->data, stats->nmask);
-    stats->calc_mean(umodel            , u->data, NoOffset   , uloc, atmp["tmp1"]->data, stats->nmask);
-    for (int n=2; n<5; ++n)
-    {
-        std::stringstream ss;
-        ss << n;
-        std::string sn = ss.str();
-        stats->calc_moment(u->data, umodel, m->profs["u"+sn].data, n, uloc,
-                          atmp["tmp1"]->data, stats->nmask);
-    }
+    // save the area coverage of the masks
+    stats->calc_area(stats->get_profs("area" ), sloc);
+    stats->calc_area(stats->get_profs("areah"), wloc);
+
+    // calculate all means and moments first, such that the means are summed in one batch before the fluxes need them
+    stats->calc_moments(stats->get_profs("w"), stats->get_profs("w2"), stats->get_profs("w3"), stats->get_profs("w4"),
+                        w->data, NoOffset, wloc);
+
+    stats->calc_moments(stats->get_profs("u"), stats->get_profs("u2"), stats->get_profs("u3"), stats->get_profs("u4"),
+                        u->data, grid->utrans, uloc);
+    stats->calc_mean(um, u->data, NoOffset, uloc);
+
+    stats->calc_moments(stats->get_profs("v"), stats->get_profs("v2"), stats->get_profs("v3"), stats->get_profs("v4"),
+                        v->data, grid->vtrans, vloc);
+    stats->calc_mean(vm, v->data, NoOffset, vloc);
+
+    for (FieldMap::const_iterator it=sp.begin(); it!=sp.end(); ++it)
+        stats->calc_moments(stats->get_profs(it->first), stats->get_profs(it->first+"2"),
+                            stats->get_profs(it->first+"3"), stats->get_profs(it->first+"4"),
+                            it->second->data, NoOffset, sloc);
+
+    stats->calc_mean(stats->get_profs("p"), sd["p"]->data, NoOffset, sloc);
 
-    // interpolate the mask on half level horizontally onto the u coordinate
-    grid->interpolate_2nd(atmp["tmp1"]->data, atmp["tmp4"]->data, wloc, uwloc);
+    if (model->diff->get_switch() == "smag2")
+        stats->calc_mean(stats->get_profs("evisc"), sd["evisc"]->data, NoOffset, sloc);
+
+    // calculate the stats on the u location
     if (grid->swspatialorder == "2")
     {
-        stats->calc_grad_2nd(u->data, m->profs["ugrad"].data, grid->dzhi, uloc,
-                            atmp["tmp1"]->data, stats->nmaskh);
-        stats->calc_flux_2nd(u->data, umodel, w->data, m->profs["w"].data,
-                            m->profs["uw"].data, atmp["tmp2"]->data, uloc,
-                            atmp["tmp1"]->data, stats->nmaskh);
+        stats->calc_grad_2nd(u->data, stats->get_profs("ugrad"), grid->dzhi, uloc);
+        stats->calc_flux_2nd(u->data, um, w->data, stats->get_profs("w"),
+                             stats->get_profs("uw"), atmp["tmp2"]->data, uloc);
         if (model->diff->get_switch() == "smag2")
             stats->calc_diff_2nd(u->data, w->data, sd["evisc"]->data,
-                                m->profs["udiff"].data, grid->dzhi,
-                                u->datafluxbot, u->datafluxtop, 1., uloc,
-                                atmp["tmp1"]->data, stats->nmaskh);
+                                 stats->get_profs("udiff"), grid->dzhi,
+                                 u->datafluxbot, u->datafluxtop, 1., uloc);
         else
-            stats->calc_diff_2nd(u->data, m->profs["udiff"].data, grid->dzhi, visc, uloc,
-                                atmp["tmp1"]->data, stats->nmaskh);
+            stats->calc_diff_2nd(u->data, stats->get_profs("udiff"), grid->dzhi, visc, uloc);
 
     }
     else if (grid->swspatialorder == "4")
     {
-        stats->calc_grad_4th(u->data, m->profs["ugrad"].data, grid->dzhi4, uloc,
-                            atmp["tmp1"]->data, stats->nmaskh);
-        stats->calc_flux_4th(u->data, w->data, m->profs["uw"].data, atmp["tmp2"]->data, uloc,
-                            atmp["tmp1"]->data, stats->nmaskh);
-        stats->calc_diff_4th(u->data, m->profs["udiff"].data, grid->dzhi4, visc, uloc,
-                            atmp["tmp1"]->data, stats->nmaskh);
+        stats->calc_grad_4th(u->data, stats->get_profs("ugrad"), grid->dzhi4, uloc);
+        stats->calc_flux_4th(u->data, w->data, stats->get_profs("uw"), atmp["tmp2"]->data, uloc);
+        stats->calc_diff_4th(u->data, stats->get_profs("udiff"), grid->dzhi4, visc, uloc);
     }
 
     // calculate the stats on the v location
-    grid->interpolate_2nd(atmp["tmp1"]->data, atmp["tmp3"]->data, sloc, vloc);
-    stats->calc_mean(m->profs["v"].data, v->data, grid->vtrans, vloc, atmp["tmp1"]->data, stats->nmask);
-    stats->calc_mean(vmodel            , v->data, NoOffset   , vloc, atmp["tmp1"]->data, stats->nmask);
-    for (int n=2; n<5; ++n)
-    {
-        std::stringstream ss;
-        ss << n;
-        std::string sn = ss.str();
-        stats->calc_moment(v->data, vmodel, m->profs["v"+sn].data, n, vloc,
-                          atmp["tmp1"]->data, stats->nmask);
-    }
-
-    // interpolate the mask on half level horizontally onto the u coordinate
-    grid->interpolate_2nd(atmp["tmp1"]->data, atmp["tmp4"]->data, wloc, vwloc);
     if (grid->swspatialorder == "2")
     {
-        stats->calc_grad_2nd(v->data, m->profs["vgrad"].data, grid->dzhi, vloc,
-                            atmp["tmp1"]->data, stats->nmaskh);
-        stats->calc_flux_2nd(v->data, vmodel, w->data, m->profs["w"].data,
-                            m->profs["vw"].data, atmp["tmp2"]->data, vloc,
-                            atmp["tmp1"]->data, stats->nmaskh);
+        stats->calc_grad_2nd(v->data, stats->get_profs("vgrad"), grid->dzhi, vloc);
+        stats->calc_flux_2nd(v->data, vm, w->data, stats->get_profs("w"),
+                             stats->get_profs("vw"), atmp["tmp2"]->data, vloc);
         if (model->diff->get_switch() == "smag2")
             stats->calc_diff_2nd(v->data, w->data, sd["evisc"]->data,
-                                m->profs["vdiff"].data, grid->dzhi,
-                                v->datafluxbot, v->datafluxtop, 1., vloc,
-                                atmp["tmp1"]->data, stats->nmaskh);
+                                 stats->get_profs("vdiff"), grid->dzhi,
+                                 v->datafluxbot, v->datafluxtop, 1., vloc);
         else
-            stats->calc_diff_2nd(v->data, m->profs["vdiff"].data, grid->dzhi, visc, vloc,
-                                atmp["tmp1"]->data, stats->nmaskh);
+            stats->calc_diff_2nd(v->data, stats->get_profs("vdiff"), grid->dzhi, visc, vloc);
 
     }
     else if (grid->swspatialorder == "4")
     {
-        stats->calc_grad_4th(v->data, m->profs["vgrad"].data, grid->dzhi4, vloc,
-                            atmp["tmp1"]->data, stats->nmaskh);
-        stats->calc_flux_4th(v->data, w->data, m->profs["vw"].data, atmp["tmp2"]->data, vloc,
-                            atmp["tmp1"]->data, stats->nmaskh);
-        stats->calc_diff_4th(v->data, m->profs["vdiff"].data, grid->dzhi4, visc, vloc,
-                            atmp["tmp1"]->data, stats->nmaskh);
+        stats->calc_grad_4th(v->data, stats->get_profs("vgrad"), grid->dzhi4, vloc);
+        stats->calc_flux_4th(v->data, w->data, stats->get_profs("vw"), atmp["tmp2"]->data, vloc);
+        stats->calc_diff_4th(v->data, stats->get_profs("vdiff"), grid->dzhi4, visc, vloc);
     }
 
     // calculate stats for the prognostic scalars
     Diff_smag_2 *diffptr = static_cast<Diff_smag_2 *>(model->diff);
     for (FieldMap::const_iterator it=sp.begin(); it!=sp.end(); ++it)
     {
-        stats->calc_mean(m->profs[it->first].data, it->second->data, NoOffset, sloc, atmp["tmp3"]->data, stats->nmask);
-        for (int n=2; n<5; ++n)
-        {
-            std::stringstream ss;
-            ss << n;
-            std::string sn = ss.str();
-            stats->calc_moment(it->second->data, m->profs[it->first].data, m->profs[it->first+sn].data, n, sloc,
-                    atmp["tmp3"]->data, stats->nmask);
-        }
         if (grid->swspatialorder == "2")
         {
-            stats->calc_grad_2nd(it->second->data, m->profs[it->first+"grad"].data, grid->dzhi, sloc,
-                                atmp["tmp4"]->data, stats->nmaskh);
-            stats->calc_flux_2nd(it->second->data, m->profs[it->first].data, w->data, m->profs["w"].data,
-                                m->profs[it->first+"w"].data, atmp["tmp1"]->data, sloc,
-                                atmp["tmp4"]->data, stats->nmaskh);
+            stats->calc_grad_2nd(it->second->data, stats->get_profs(it->first+"grad"), grid->dzhi, sloc);
+            stats->calc_flux_2nd(it->second->data, stats->get_profs(it->first), w->data, stats->get_profs("w"),
+                                 stats->get_profs(it->first+"w"), atmp["tmp1"]->data, sloc);
             if (model->diff->get_switch() == "smag2")
                 stats->calc_diff_2nd(it->second->data, w->data, sd["evisc"]->data,
-                                    m->profs[it->first+"diff"].data, grid->dzhi,
-                                    it->second->datafluxbot, it->second->datafluxtop, diffptr->tPr, sloc,
-                                    atmp["tmp4"]->data, stats->nmaskh);
+                                     stats->get_profs(it->first+"diff"), grid->dzhi,
+                                     it->second->datafluxbot, it->second->datafluxtop, diffptr->tPr, sloc);
             else
-                stats->calc_diff_2nd(it->second->data, m->profs[it->first+"diff"].data, grid->dzhi, it->second->visc, sloc,
-                                    atmp["tmp4"]->data, stats->nmaskh);
+                stats->calc_diff_2nd(it->second->data, stats->get_profs(it->first+"diff"), grid->dzhi, it->second->visc, sloc);
         }
         else if (grid->swspatialorder == "4")
         {
-            stats->calc_grad_4th(it->second->data, m->profs[it->first+"grad"].data, grid->dzhi4, sloc,
-                                atmp["tmp4"]->data, stats->nmaskh);
-            stats->calc_flux_4th(it->second->data, w->data, m->profs[it->first+"w"].data, atmp["tmp1"]->data, sloc,
-                                atmp["tmp4"]->data, stats->nmaskh);
-            stats->calc_diff_4th(it->second->data, m->profs[it->first+"diff"].data, grid->dzhi4, it->second->visc, sloc,
-                                atmp["tmp4"]->data, stats->nmaskh);
+            stats->calc_grad_4th(it->second->data, stats->get_profs(it->first+"grad"), grid->dzhi4, sloc);
+            stats->calc_flux_4th(it->second->data, w->data, stats->get_profs(it->first+"w"), atmp["tmp1"]->data, sloc);
+            stats->calc_diff_4th(it->second->data, stats->get_profs(it->first+"diff"), grid->dzhi4, it->second->visc, sloc);
         }
     }
 
     // Calculate pressure statistics
-    stats->calc_mean(m->profs["p"].data, sd["p"]->data, NoOffset, sloc, atmp["tmp3"]->data, stats->nmask);
-    stats->calc_moment(sd["p"]->data, m->profs["p"].data, m->profs["p2"].data, 2, sloc,
-                      atmp["tmp1"]->data, stats->nmask);
+    stats->calc_moment(sd["p"]->data, stats->get_profs("p"), stats->get_profs("p2"), 2, sloc);
     if (grid->swspatialorder == "2")
     {
-        stats->calc_grad_2nd(sd["p"]->data, m->profs["pgrad"].data, grid->dzhi, sloc,
-                             atmp["tmp4"]->data, stats->nmaskh);
-        stats->calc_flux_2nd(sd["p"]->data, m->profs["p"].data, w->data, m->profs["w"].data,
-                            m->profs["pw"].data, atmp["tmp1"]->data, sloc,
-                            atmp["tmp4"]->data, stats->nmaskh);
+        stats->calc_grad_2nd(sd["p"]->data, stats->get_profs("pgrad"), grid->dzhi, sloc);
+        stats->calc_flux_2nd(sd["p"]->data, stats->get_profs("p"), w->data, stats->get_profs("w"),
+                             stats->get_profs("pw"), atmp["tmp1"]->data, sloc);
     }
     else if (grid->swspatialorder == "4")
     {
-        stats->calc_grad_4th(sd["p"]->data, m->profs["pgrad"].data, grid->dzhi4, sloc,
-                             atmp["tmp4"]->data, stats->nmaskh);
-        stats->calc_flux_4th(sd["p"]->data, w->data, m->profs["pw"].data, atmp["tmp1"]->data, sloc,
-                             atmp["tmp4"]->data, stats->nmaskh);
+        stats->calc_grad_4th(sd["p"]->data, stats->get_profs("pgrad"), grid->dzhi4, sloc);
+        stats->calc_flux_4th(sd["p"]->data, w->data, stats->get_profs("pw"), atmp["tmp1"]->data, sloc);
     }
 
     // calculate the total fluxes
-    stats->add_fluxes(m->profs["uflux"].data, m->profs["uw"].data, m->profs["udiff"].data);
-    stats->add_fluxes(m->profs["vflux"].data, m->profs["vw"].data, m->profs["vdiff"].data);
+    stats->add_fluxes(stats->get_profs("uflux"), stats->get_profs("uw"), stats->get_profs("udiff"));
+    stats->add_fluxes(stats->get_profs("vflux"), stats->get_profs("vw"), stats->get_profs("vdiff"));
     for (FieldMap::const_iterator it=sp.begin(); it!=sp.end(); ++it)
-        stats->add_fluxes(m->profs[it->first+"flux"].data, m->profs[it->first+"w"].data, m->profs[it->first+"diff"].data);
-
-    if (model->diff->get_switch() == "smag2")
-        stats->calc_mean(m->profs["evisc"].data, sd["evisc"]->data, NoOffset, sloc, atmp["tmp3"]->data, stats->nmask);
+        stats->add_fluxes(stats->get_profs(it->first+"flux"), stats->get_profs(it->first+"w"), stats->get_profs(it->first+"diff"));
 }
 
 void Fields::set_calc_mean_profs(bool sw)
@@ -588,6 +571,88 @@ void Fields::set_minimum_tmp_fields(int n)
     n_tmp_fields = std::max(n_tmp_fields, n);
 }
 
+void Fields::set_minimum_tmp_fields_2d(int n)
+{
+    n_tmp_fields_2d = std::max(n_tmp_fields_2d, n);
+    n_tmp_fields    = std::max(n_tmp_fields, n);
+}
+
+/**
+ * This function sets the minimum number of tmp fields for nfields full fields and nslices
+ * slices of the size of an xz plane that are borrowed in the same scope. The number of tmp fields
+ * that the slices need depends on the grid, therefore it is calculated in init().
+ */
+void Fields::set_minimum_tmp_fields_xz(int nfields, int nslices)
+{
+    n_tmp_fields_xz.push_back(std::make_pair(nfields, nslices));
+}
+
+Field3d* Fields::get_tmp(const bool with2d)
+{
+    // Take the last available field, skip the fields without 2d arrays if they are needed.
+    for (int n=tmp_pool.size()-1; n>=0; --n)
+    {
+        if (with2d && tmp_pool[n]->databot == 0)
+            continue;
+
+        Field3d* fld = tmp_pool[n];
+        tmp_pool.erase(tmp_pool.begin() + n);
+        return fld;
+    }
+
+    master->print_error("No tmp field%s available, increase the number with set_minimum_tmp_fields%s\n",
+                        with2d ? " with 2d arrays" : "", with2d ? "_2d" : "");
+    throw 1;
+}
+
+void Fields::release_tmp(Field3d* fld)
+{
+    tmp_pool.push_back(fld);
+}
+
+Tmp_fields::Tmp_fields(Fields* fieldsin) :
+    fields(fieldsin),
+    grid(fieldsin->grid),
+    slice_data(0),
+    slice_used(0)
+{
+}
+
+Tmp_fields::~Tmp_fields()
+{
+    // return the fields in the reverse order of borrowing
+    for (std::vector<Field3d*>::reverse_iterator it=borrowed.rbegin(); it!=borrowed.rend(); ++it)
+        fields->release_tmp(*it);
+}
+
+Field3d* Tmp_fields::get_field(const bool with2d)
+{
+    borrowed.push_back(fields->get_tmp(with2d));
+    return borrowed.back();
+}
+
+int Tmp_fields::get_slice_size(const int n)
+{
+    // Start each slice at a multiple of 64 bytes, as the fields are aligned.
+    const int nalign = 64/sizeof(double);
+    return (n + nalign - 1) / nalign * nalign;
+}
+
+double* Tmp_fields::get_slice(const int n)
+{
+    const int nslice = get_slice_size(n);
+
+    if (slice_data == 0 || slice_used + nslice > grid->ncells)
+    {
+        slice_data = get_field()->data;
+        slice_used = 0;
+    }
+
+    double* slice = &slice_data[slice_used];
+    slice_used += nslice;
+    return slice;
+}
+
 void Fields::init_momentum_field(Field3d*& fld, Field3d*& fldt, std::string fldname, std::string longname, std::string unit)
 {
     if (mp.find(fldname)!=mp.end())
@@ -87,6 +87,9 @@ Grid::Grid(Model *modelin, Input *inputin)
     nerror += inputin->get_item(&vtrans, "grid", "vtrans", "", 0.);
 
     nerror += inputin->get_item(&swspatialorder, "grid", "swspatialorder", "");
+    nerror += inputin->get_item(&swtranspose, "grid", "swtranspose", "", "p2p");
+    nerror += inputin->get_item(&fftchunks, "grid", "fftchunks", "", 4);
+    nerror += inputin->get_item(&swrowpadding, "grid", "swrowpadding", "", "0");
 
     if (nerror)
         throw 1;
@@ -96,6 +99,21 @@ Grid::Grid(Model *modelin, Input *inputin)
         master->print_error("\"%s\" is an illegal value for swspatialorder\n", swspatialorder.c_str());
         throw 1;
     }
+    if (!(swtranspose == "p2p" || swtranspose == "alltoall" || swtranspose == "auto"))
+    {
+        master->print_error("\"%s\" is an illegal value for swtranspose\n", swtranspose.c_str());
+        throw 1;
+    }
+    if (!(swrowpadding == "0" || swrowpadding == "1"))
+    {
+        master->print_error("\"%s\" is an illegal value for swrowpadding\n", swrowpadding.c_str());
+        throw 1;
+    }
+    if (fftchunks < 1)
+    {
+        master->print_error("fftchunks = %d, but should be at least 1\n", fftchunks);
+        throw 1;
+    }
     // 2nd order scheme requires only 1 ghost cell
     if (swspatialorder == "2")
     {
@@ -123,6 +141,10 @@ Grid::~Grid()
         fftw_destroy_plan(iplanb);
         fftw_destroy_plan(jplanf);
         fftw_destroy_plan(jplanb);
+        fftw_destroy_plan(iplanfblock);
+        fftw_destroy_plan(iplanbblock);
+        fftw_destroy_plan(jplanfblock);
+        fftw_destroy_plan(jplanbblock);
     }
 
     delete[] x;
@@ -143,7 +165,11 @@ Grid::~Grid()
     fftw_free(fftinj);
     fftw_free(fftoutj);
 
+#ifdef USEOMP
+    fftw_cleanup_threads();
+#else
     fftw_cleanup();
+#endif
 
 #ifdef USECUDA
     clear_device();
@@ -200,12 +226,28 @@ void Grid::init()
     jblock = jtot / master->npx;
     kblock = ktot / master->npx;
 
+    // The FFTs are done in chunks of equal size, thus the number of chunks has to divide kblock.
+    fftchunks = std::min(fftchunks, kblock);
+    while (kblock % fftchunks != 0)
+        --fftchunks;
+
     // Calculate the grid dimensions including ghost cells.
     icells  = (imax+2*igc);
     jcells  = (jmax+2*jgc);
-    ijcells = icells*jcells;
     kcells  = (kmax+2*kgc);
-    ncells  = (imax+2*igc)*(jmax+2*jgc)*(kmax+2*kgc);
+
+    // Pad the rows to a multiple of 64 bytes, such that all rows of the aligned fields are aligned.
+    // A power of two is avoided, as it maps the same column of subsequent rows onto the same cache set.
+    if (swrowpadding == "1")
+    {
+        const int nalign = 64/sizeof(double);
+        icells = (icells + nalign - 1) / nalign * nalign;
+        if ((icells & (icells-1)) == 0)
+            icells += nalign;
+    }
+
+    ijcells = icells*jcells;
+    ncells  = icells*jcells*kcells;
 
     // Calculate the starting and ending points for loops over the grid.
     istart = igc;
@@ -219,8 +261,8 @@ void Grid::init()
     check_ghost_cells();
 
     // allocate all arrays
-    x     = new double[imax+2*igc];
-    xh    = new double[imax+2*igc];
+    x     = new double[icells];
+    xh    = new double[icells];
     y     = new double[jmax+2*jgc];
     yh    = new double[jmax+2*jgc];
     z     = new double[kmax+2*kgc];
@@ -232,6 +274,16 @@ void Grid::init()
     dzi4  = new double[kmax+2*kgc];
     dzhi4 = new double[kmax+2*kgc];
 
+#ifdef USEOMP
+    // let FFTW use the threads of this process, this has to be set before the plans are made
+    if (!fftw_init_threads())
+    {
+        master->print_error("FFTW threads cannot be initialized\n");
+        throw 1;
+    }
+    fftw_plan_with_nthreads(master->nthreads);
+#endif
+
     // allocate the data for the fourier transforms
     fftini  = fftw_alloc_real(itot*jmax);
     fftouti = fftw_alloc_real(itot*jmax);
@@ -530,3 +582,100 @@ void Grid::calc_mean(double* restrict prof, const double* restrict data, const i
     for (int k=0; k<krange; ++k)
         prof[k] /= n;
 }
+
+/**
+ * This function creates the FFTW3 plans of the transforms in x and y. If the wisdom
+ * of a previous run has been imported, the plans are identical to those of that run.
+ */
+void Grid::create_fft_plans()
+{
+    // use the FFTW3 many interface in order to reduce function call overhead
+    int rank = 1;
+    int ni[] = {itot};
+    int nj[] = {jtot};
+    int istride = 1;
+    int jstride = iblock;
+    int idist = itot;
+    int jdist = 1;
+
+    fftw_r2r_kind kindf[] = {FFTW_R2HC};
+    fftw_r2r_kind kindb[] = {FFTW_HC2R};
+
+    iplanf = fftw_plan_many_r2r(rank, ni, jmax, fftini, ni, istride, idist,
+                                fftouti, ni, istride, idist, kindf, FFTW_EXHAUSTIVE);
+    iplanb = fftw_plan_many_r2r(rank, ni, jmax, fftini, ni, istride, idist,
+                                fftouti, ni, istride, idist, kindb, FFTW_EXHAUSTIVE);
+    jplanf = fftw_plan_many_r2r(rank, nj, iblock, fftinj, nj, jstride, jdist,
+                                fftoutj, nj, jstride, jdist, kindf, FFTW_EXHAUSTIVE);
+    jplanb = fftw_plan_many_r2r(rank, nj, iblock, fftinj, nj, jstride, jdist,
+                                fftoutj, nj, jstride, jdist, kindb, FFTW_EXHAUSTIVE);
+
+    create_fft_block_plans();
+
+    fftwplan = true;
+}
+
+/**
+ * This function creates the FFTW3 plans that transform all levels of a chunk in place in a single execution.
+ * The plans are created on aligned scratch arrays and applied with fftw_execute_r2r to the actual data.
+ */
+void Grid::create_fft_block_plans()
+{
+    const int nk = kblock/fftchunks;
+    double* tmp = fftw_alloc_real(std::max(itot*jmax, iblock*jtot)*nk);
+
+    fftw_r2r_kind kindf[] = {FFTW_R2HC};
+    fftw_r2r_kind kindb[] = {FFTW_HC2R};
+
+    // the x-transforms are contiguous, the rows of all levels are one batch
+    fftw_iodim idim = {itot, 1, 1};
+    fftw_iodim ihowmany = {jmax*nk, itot, itot};
+
+    // the y-transforms are strided by iblock, the batch runs over i and over the levels
+    fftw_iodim jdim = {jtot, iblock, iblock};
+    fftw_iodim jhowmany[] = {{iblock, 1, 1}, {nk, iblock*jtot, iblock*jtot}};
+
+    iplanfblock = fftw_plan_guru_r2r(1, &idim, 1, &ihowmany, tmp, tmp, kindf, FFTW_EXHAUSTIVE);
+    iplanbblock = fftw_plan_guru_r2r(1, &idim, 1, &ihowmany, tmp, tmp, kindb, FFTW_EXHAUSTIVE);
+    jplanfblock = fftw_plan_guru_r2r(1, &jdim, 2, jhowmany , tmp, tmp, kindf, FFTW_EXHAUSTIVE);
+    jplanbblock = fftw_plan_guru_r2r(1, &jdim, 2, jhowmany , tmp, tmp, kindb, FFTW_EXHAUSTIVE);
+
+    fftw_free(tmp);
+}
+
+/**
+ * This function transforms a chunk of levels in place and stores the result divided by scale in out.
+ * If the data does not have the alignment of the arrays the plans were created with, the transforms
+ * are done slice by slice via the help arrays.
+ */
+void Grid::fft_block(fftw_plan blockplan, fftw_plan sliceplan,
+                     double* in, double* out, double* restrict fftin, double* restrict fftout,
+                     const int nk, const int levelsize, const double scale)
+{
+    if (fftw_alignment_of(in) == 0)
+    {
+        fftw_execute_r2r(blockplan, in, in);
+
+        if (in != out || scale != 1.)
+        {
+#pragma ivdep
+            for (int n=0; n<nk*levelsize; n++)
+                out[n] = in[n] / scale;
+        }
+    }
+    else
+    {
+        for (int k=0; k<nk; k++)
+        {
+#pragma ivdep
+            for (int n=0; n<levelsize; n++)
+                fftin[n] = in[n + k*levelsize];
+
+            fftw_execute(sliceplan);
+
+#pragma ivdep
+            for (int n=0; n<levelsize; n++)
+                out[n + k*levelsize] = fftout[n] / scale;
+        }
+    }
+}
@@ -23,10 +23,70 @@
 #ifdef USEMPI
 #include <fftw3.h>
 #include <cstdio>
+#include <vector>
+#include <map>
+#include <tuple>
 #include "master.h"
 #include "grid.h"
 #include "defines.h"
 
+namespace
+{
+    // Copy a block of ghost cells of all levels into a contiguous buffer.
+    void pack_block(double* restrict buf, const double* restrict data,
+                    const int i0, const int j0, const int ni, const int nj,
+                    const int kcells, const int icells, const int ijcells)
+    {
+        for (int k=0; k<kcells; k++)
+            for (int j=0; j<nj; j++)
+#pragma ivdep
+                for (int i=0; i<ni; i++)
+                {
+                    const int ijk = (i+i0) + (j+j0)*icells + k*ijcells;
+                    const int n   = i + j*ni + k*ni*nj;
+                    buf[n] = data[ijk];
+                }
+    }
+
+    // Copy a contiguous buffer back into a block of ghost cells of all levels.
+    void unpack_block(double* restrict data, const double* restrict buf,
+                      const int i0, const int j0, const int ni, const int nj,
+                      const int kcells, const int icells, const int ijcells)
+    {
+        for (int k=0; k<kcells; k++)
+            for (int j=0; j<nj; j++)
+#pragma ivdep
+                for (int i=0; i<ni; i++)
+                {
+                    const int ijk = (i+i0) + (j+j0)*icells + k*ijcells;
+                    const int n   = i + j*ni + k*ni*nj;
+                    data[ijk] = buf[n];
+                }
+    }
+
+    // Size of a datatype in bytes, for the communication profiler.
+    double type_bytes(MPI_Datatype type)
+    {
+        int size;
+        MPI_Type_size(type, &size);
+        return size;
+    }
+
+    // Start all persistent requests of a communication pattern.
+    void start_requests(std::vector<MPI_Request>& reqs)
+    {
+        if (!reqs.empty())
+            MPI_Startall(reqs.size(), &reqs[0]);
+    }
+
+    // Wait until all persistent requests of a communication pattern are complete.
+    void wait_requests(std::vector<MPI_Request>& reqs)
+    {
+        if (!reqs.empty())
+            MPI_Waitall(reqs.size(), &reqs[0], MPI_STATUSES_IGNORE);
+    }
+}
+
 // MPI functions
 void Grid::init_mpi()
 {
@@ -61,6 +121,25 @@ void Grid::init_mpi()
     MPI_Type_vector(datacount, datablock, datastride, MPI_DOUBLE, &northsouthedge2d);
     MPI_Type_commit(&northsouthedge2d);
 
+    // east west, north south and corners without overlap, to exchange all ghost cells in one pass
+    MPI_Datatype edgeslice;
+    const MPI_Aint kstride = ijcells*sizeof(double);
+
+    MPI_Type_vector(jmax, igc, icells, MPI_DOUBLE, &edgeslice);
+    MPI_Type_create_hvector(kcells, 1, kstride, edgeslice, &eastwestedgeinner);
+    MPI_Type_commit(&eastwestedgeinner);
+    MPI_Type_free(&edgeslice);
+
+    MPI_Type_vector(jgc, imax, icells, MPI_DOUBLE, &edgeslice);
+    MPI_Type_create_hvector(kcells, 1, kstride, edgeslice, &northsouthedgeinner);
+    MPI_Type_commit(&northsouthedgeinner);
+    MPI_Type_free(&edgeslice);
+
+    MPI_Type_vector(jgc, igc, icells, MPI_DOUBLE, &edgeslice);
+    MPI_Type_create_hvector(kcells, 1, kstride, edgeslice, &corneredge);
+    MPI_Type_commit(&corneredge);
+    MPI_Type_free(&edgeslice);
+
     // transposez
     datacount = imax*jmax*kblock;
     MPI_Type_contiguous(datacount, MPI_DOUBLE, &transposez);
@@ -99,6 +178,36 @@ void Grid::init_mpi()
     MPI_Type_vector(datacount, datablock, datastride, MPI_DOUBLE, &transposey2);
     MPI_Type_commit(&transposey2);
 
+    // single levels of the transpose blocks, resized to the extent of a full level of the
+    // array such that a count of multiple levels can be sent in the chunked transposes
+    MPI_Datatype level;
+
+    MPI_Type_contiguous(imax*jmax, MPI_DOUBLE, &transposezlevel);
+    MPI_Type_commit(&transposezlevel);
+
+    MPI_Type_contiguous(iblock*jblock, MPI_DOUBLE, &transposez2level);
+    MPI_Type_commit(&transposez2level);
+
+    MPI_Type_vector(jmax, imax, itot, MPI_DOUBLE, &level);
+    MPI_Type_create_resized(level, 0, itot*jmax*sizeof(double), &transposexlevel);
+    MPI_Type_commit(&transposexlevel);
+    MPI_Type_free(&level);
+
+    MPI_Type_vector(jmax, iblock, itot, MPI_DOUBLE, &level);
+    MPI_Type_create_resized(level, 0, itot*jmax*sizeof(double), &transposex2level);
+    MPI_Type_commit(&transposex2level);
+    MPI_Type_free(&level);
+
+    MPI_Type_contiguous(iblock*jmax, MPI_DOUBLE, &level);
+    MPI_Type_create_resized(level, 0, iblock*jtot*sizeof(double), &transposeylevel);
+    MPI_Type_commit(&transposeylevel);
+    MPI_Type_free(&level);
+
+    MPI_Type_contiguous(iblock*jblock, MPI_DOUBLE, &level);
+    MPI_Type_create_resized(level, 0, iblock*jtot*sizeof(double), &transposey2level);
+    MPI_Type_commit(&transposey2level);
+    MPI_Type_free(&level);
+
     // file saving and loading, take C-ordering into account
     int totsizei  = itot;
     int subsizei  = imax;
@@ -143,10 +252,21 @@ void Grid::init_mpi()
     MPI_Type_create_subarray(2, totxysize, subxysize, subxystart, MPI_ORDER_C, MPI_DOUBLE, &subxyslice);
     MPI_Type_commit(&subxyslice);
 
+    // blocks of the alltoall transposes, equivalent to the transpose datatypes
+    blockz  = { imax  , jmax  , kblock, 0     , 0     , kblock, imax  , imax*jmax     };
+    blockz2 = { iblock, jblock, kblock, 0     , 0     , kblock, iblock, iblock*jblock };
+    blockx  = { imax  , jmax  , kblock, imax  , 0     , 0     , itot  , itot*jmax     };
+    blockx2 = { iblock, jmax  , kblock, iblock, 0     , 0     , itot  , itot*jmax     };
+    blocky  = { iblock, jmax  , kblock, 0     , jmax  , 0     , iblock, iblock*jtot   };
+    blocky2 = { iblock, jblock, kblock, 0     , jblock, 0     , iblock, iblock*jtot   };
+
     // allocate the array for the profiles
     profl = new double[kcells];
 
     mpitypes = true;
+
+    // select the communication backend of the transposes
+    tune_transposes();
 } 
 
 void Grid::exit_mpi()
@@ -157,12 +277,21 @@ void Grid::exit_mpi()
         MPI_Type_free(&northsouthedge);
         MPI_Type_free(&eastwestedge2d);
         MPI_Type_free(&northsouthedge2d);
+        MPI_Type_free(&eastwestedgeinner);
+        MPI_Type_free(&northsouthedgeinner);
+        MPI_Type_free(&corneredge);
         MPI_Type_free(&transposez);
         MPI_Type_free(&transposez2);
         MPI_Type_free(&transposex);
         MPI_Type_free(&transposex2);
         MPI_Type_free(&transposey);
         MPI_Type_free(&transposey2);
+        MPI_Type_free(&transposezlevel);
+        MPI_Type_free(&transposez2level);
+        MPI_Type_free(&transposexlevel);
+        MPI_Type_free(&transposex2level);
+        MPI_Type_free(&transposeylevel);
+        MPI_Type_free(&transposey2level);
         MPI_Type_free(&subi);
         MPI_Type_free(&subj);
         MPI_Type_free(&subarray);
@@ -170,16 +299,109 @@ void Grid::exit_mpi()
         MPI_Type_free(&subyzslice);
         MPI_Type_free(&subxyslice);
 
+        for (std::map<Request_key, std::vector<MPI_Request> >::iterator it=persistent_requests.begin(); it!=persistent_requests.end(); ++it)
+            for (std::vector<MPI_Request>::iterator req=it->second.begin(); req!=it->second.end(); ++req)
+                MPI_Request_free(&(*req));
+
         delete[] profl;
     }
 }
 
+std::vector<MPI_Request>& Grid::get_requests(Comm_pattern pattern, int variant, const double* ar, const double* as)
+{
+    // The key determines the buffers, datatypes and neighbors of the requests completely,
+    // such that requests found in the map can always be restarted.
+    return persistent_requests[std::make_tuple(pattern, variant, ar, as)];
+}
+
+void Grid::free_requests(const double* buf)
+{
+    std::map<Request_key, std::vector<MPI_Request> >::iterator it=persistent_requests.begin();
+    while (it != persistent_requests.end())
+    {
+        if (std::get<2>(it->first) == buf || std::get<3>(it->first) == buf)
+        {
+            for (std::vector<MPI_Request>::iterator req=it->second.begin(); req!=it->second.end(); ++req)
+                MPI_Request_free(&(*req));
+            persistent_requests.erase(it++);
+        }
+        else
+            ++it;
+    }
+}
+
 void Grid::boundary_cyclic(double* restrict data, Edge edge)
 {
+    boundary_cyclic_start (data, edge);
+    boundary_cyclic_finish(data, edge);
+}
+
+void Grid::boundary_cyclic_start(double* restrict data, Edge edge)
+{
+    // The requests of a field are created at its first exchange and restarted afterwards.
+    std::vector<MPI_Request>& reqs = get_requests(Halo_3d, edge, data, data);
+    if (!reqs.empty())
+    {
+        start_requests(reqs);
+        return;
+    }
+
     const int ncount = 1;
+    int nr = 0;
 
-    if (edge == East_west_edge || edge == Both_edges)
+    // In 3D, all edges and corners are exchanged at once, such that only a single wait is needed.
+    if (edge == Both_edges && jtot > 1)
     {
+        reqs.resize(16);
+
+        const int jj = icells;
+
+        // Communicate the east-west edges without the corners.
+        const int eastout = iend-igc + jstart*jj;
+        const int westin  = 0        + jstart*jj;
+        const int westout = istart   + jstart*jj;
+        const int eastin  = iend     + jstart*jj;
+
+        MPI_Send_init(&data[eastout], ncount, eastwestedgeinner, master->neast, 1, master->commxy, &reqs[nr++]);
+        MPI_Recv_init(&data[westin], ncount, eastwestedgeinner, master->nwest, 1, master->commxy, &reqs[nr++]);
+        MPI_Send_init(&data[westout], ncount, eastwestedgeinner, master->nwest, 2, master->commxy, &reqs[nr++]);
+        MPI_Recv_init(&data[eastin], ncount, eastwestedgeinner, master->neast, 2, master->commxy, &reqs[nr++]);
+
+        // Communicate the north-south edges without the corners.
+        const int northout = istart + (jend-jgc)*jj;
+        const int southin  = istart + 0         *jj;
+        const int southout = istart + jstart    *jj;
+        const int northin  = istart + jend      *jj;
+
+        MPI_Send_init(&data[northout], ncount, northsouthedgeinner, master->nnorth, 3, master->commxy, &reqs[nr++]);
+        MPI_Recv_init(&data[southin], ncount, northsouthedgeinner, master->nsouth, 3, master->commxy, &reqs[nr++]);
+        MPI_Send_init(&data[southout], ncount, northsouthedgeinner, master->nsouth, 4, master->commxy, &reqs[nr++]);
+        MPI_Recv_init(&data[northin], ncount, northsouthedgeinner, master->nnorth, 4, master->commxy, &reqs[nr++]);
+
+        // Communicate the corners with the diagonal neighbors.
+        const int northeastout = iend-igc + (jend-jgc)*jj;
+        const int southwestin  = 0        + 0         *jj;
+        const int southwestout = istart   + jstart    *jj;
+        const int northeastin  = iend     + jend      *jj;
+        const int northwestout = istart   + (jend-jgc)*jj;
+        const int southeastin  = iend     + 0         *jj;
+        const int southeastout = iend-igc + jstart    *jj;
+        const int northwestin  = 0        + jend      *jj;
+
+        MPI_Send_init(&data[northeastout], ncount, corneredge, master->nnortheast, 5, master->commxy, &reqs[nr++]);
+        MPI_Recv_init(&data[southwestin], ncount, corneredge, master->nsouthwest, 5, master->commxy, &reqs[nr++]);
+        MPI_Send_init(&data[southwestout], ncount, corneredge, master->nsouthwest, 6, master->commxy, &reqs[nr++]);
+        MPI_Recv_init(&data[northeastin], ncount, corneredge, master->nnortheast, 6, master->commxy, &reqs[nr++]);
+        MPI_Send_init(&data[northwestout], ncount, corneredge, master->nnorthwest, 7, master->commxy, &reqs[nr++]);
+        MPI_Recv_init(&data[southeastin], ncount, corneredge, master->nsoutheast, 7, master->commxy, &reqs[nr++]);
+        MPI_Send_init(&data[southeastout], ncount, corneredge, master->nsoutheast, 8, master->commxy, &reqs[nr++]);
+        MPI_Recv_init(&data[northwestin], ncount, corneredge, master->nnorthwest, 8, master->commxy, &reqs[nr++]);
+    }
+
+    else if (edge == East_west_edge || edge == Both_edges)
+    {
+        reqs.resize(4);
+
         // Communicate east-west edges.
         const int eastout = iend-igc;
         const int westin  = 0;
@@ -187,46 +409,146 @@ void Grid::boundary_cyclic(double* restrict data, Edge edge)
         const int eastin  = iend;
 
         // Send and receive the ghost cells in east-west direction.
-        MPI_Isend(&data[eastout], ncount, eastwestedge, master->neast, 1, master->commxy, &master->reqs[master->reqsn]);
-        master->reqsn++;
-        MPI_Irecv(&data[westin], ncount, eastwestedge, master->nwest, 1, master->commxy, &master->reqs[master->reqsn]);
-        master->reqsn++;
-        MPI_Isend(&data[westout], ncount, eastwestedge, master->nwest, 2, master->commxy, &master->reqs[master->reqsn]);
-        master->reqsn++;
-        MPI_Irecv(&data[eastin], ncount, eastwestedge, master->neast, 2, master->commxy, &master->reqs[master->reqsn]);
-        master->reqsn++;
-        // Wait here for the MPI to have correct values in the corners of the cells.
-        master->wait_all();
+        MPI_Send_init(&data[eastout], ncount, eastwestedge, master->neast, 1, master->commxy, &reqs[nr++]);
+        MPI_Recv_init(&data[westin], ncount, eastwestedge, master->nwest, 1, master->commxy, &reqs[nr++]);
+        MPI_Send_init(&data[westout], ncount, eastwestedge, master->nwest, 2, master->commxy, &reqs[nr++]);
+        MPI_Recv_init(&data[eastin], ncount, eastwestedge, master->neast, 2, master->commxy, &reqs[nr++]);
+    }
+
+    else if (edge == North_south_edge && jtot > 1)
+    {
+        reqs.resize(4);
+
+        // Communicate north-south edges.
+        const int northout = (jend-jgc)*icells;
+        const int southin  = 0;
+        const int southout = jstart*icells;
+        const int northin  = jend  *icells;
+
+        // Send and receive the ghost cells in the north-south direction.
+        MPI_Send_init(&data[northout], ncount, northsouthedge, master->nnorth, 1, master->commxy, &reqs[nr++]);
+        MPI_Recv_init(&data[southin], ncount, northsouthedge, master->nsouth, 1, master->commxy, &reqs[nr++]);
+        MPI_Send_init(&data[southout], ncount, northsouthedge, master->nsouth, 2, master->commxy, &reqs[nr++]);
+        MPI_Recv_init(&data[northin], ncount, northsouthedge, master->nnorth, 2, master->commxy, &reqs[nr++]);
     }
 
-    if (edge == North_south_edge || edge == Both_edges)
+    start_requests(reqs);
+}
+
+void Grid::boundary_cyclic_finish(double* restrict data, Edge edge)
+{
+    const double start = master->comm_start();
+    wait_requests(get_requests(Halo_3d, edge, data, data));
+
+    // The time between start and finish is available for computations, only the wait is profiled.
+    if (edge == Both_edges && jtot > 1)
+        master->comm_stop(Comm_boundary_cyclic, start,
+                2.*(type_bytes(eastwestedgeinner) + type_bytes(northsouthedgeinner) + 2.*type_bytes(corneredge)), 8);
+    else if (edge == East_west_edge || edge == Both_edges)
+        master->comm_stop(Comm_boundary_cyclic, start, 2.*type_bytes(eastwestedge), 2);
+    else if (edge == North_south_edge && jtot > 1)
+        master->comm_stop(Comm_boundary_cyclic, start, 2.*type_bytes(northsouthedge), 2);
+
+    // In case of 2D, fill all the ghost cells in the y-direction with the same value.
+    // This is done after the east-west exchange, such that the corners are correct.
+    if ((edge == North_south_edge || edge == Both_edges) && jtot == 1)
     {
-        // If the run is 3D, perform the cyclic boundary routine for the north-south direction.
-        if (jtot > 1)
+        const int jj = icells;
+        const int kk = icells*jcells;
+
+        for (int k=kstart; k<kend; k++)
+            for (int j=0; j<jgc; j++)
+#pragma ivdep
+                for (int i=0; i<icells; i++)
+                {
+                    const int ijkref   = i + jstart*jj   + k*kk;
+                    const int ijknorth = i + j*jj        + k*kk;
+                    const int ijksouth = i + (jend+j)*jj + k*kk;
+                    data[ijknorth] = data[ijkref];
+                    data[ijksouth] = data[ijkref];
+                }
+    }
+}
+
+void Grid::boundary_cyclic(const std::vector<double*>& data)
+{
+    const int nfields = data.size();
+    if (nfields == 0)
+        return;
+
+    // In 3D, the edges and corners are sent in the order east, west, north, south,
+    // northeast, southwest, northwest and southeast. In 2D, only east and west are
+    // needed, including the ghost cells in the y-direction as in the single field exchange.
+    const int nedge = (jtot > 1) ? 8 : 2;
+    const int jew   = (jtot > 1) ? jstart : 0;
+    const int njew  = (jtot > 1) ? jmax : jcells;
+
+    const int ni    [8] = { igc, igc, imax, imax, igc, igc, igc, igc };
+    const int nj    [8] = { njew, njew, jgc, jgc, jgc, jgc, jgc, jgc };
+    const int isend [8] = { iend-igc, istart, istart, istart, iend-igc, istart, istart, iend-igc };
+    const int jsend [8] = { jew, jew, jend-jgc, jstart, jend-jgc, jstart, jend-jgc, jstart };
+    const int irecv [8] = { 0, iend, istart, istart, 0, iend, iend, 0 };
+    const int jrecv [8] = { jew, jew, 0, jend, 0, jend, 0, jend };
+    const int nsend [8] = { master->neast, master->nwest, master->nnorth, master->nsouth,
+                            master->nnortheast, master->nsouthwest, master->nnorthwest, master->nsoutheast };
+    const int nrecv [8] = { master->nwest, master->neast, master->nsouth, master->nnorth,
+                            master->nsouthwest, master->nnortheast, master->nsoutheast, master->nnorthwest };
+
+    // Compute the offset of each edge in the buffers, each edge holds the block of all fields.
+    int offset[9];
+    offset[0] = 0;
+    for (int n=0; n<nedge; ++n)
+        offset[n+1] = offset[n] + nfields*ni[n]*nj[n]*kcells;
+
+    if (static_cast<int>(halosend.size()) < offset[nedge])
+    {
+        halosend.resize(offset[nedge]);
+        halorecv.resize(offset[nedge]);
+    }
+
+    // The requests are created once for each buffer and number of fields, the receives come first.
+    std::vector<MPI_Request>& reqs = get_requests(Halo_multi, nfields, halosend.data(), halorecv.data());
+    if (reqs.empty())
+    {
+        reqs.resize(2*nedge);
+        for (int n=0; n<nedge; ++n)
         {
-            // Communicate north-south edges.
-            const int northout = (jend-jgc)*icells;
-            const int southin  = 0;
-            const int southout = jstart*icells;
-            const int northin  = jend  *icells;
-
-            // Send and receive the ghost cells in the north-south direction.
-            MPI_Isend(&data[northout], ncount, northsouthedge, master->nnorth, 1, master->commxy, &master->reqs[master->reqsn]);
-            master->reqsn++;
-            MPI_Irecv(&data[southin], ncount, northsouthedge, master->nsouth, 1, master->commxy, &master->reqs[master->reqsn]);
-            master->reqsn++;
-            MPI_Isend(&data[southout], ncount, northsouthedge, master->nsouth, 2, master->commxy, &master->reqs[master->reqsn]);
-            master->reqsn++;
-            MPI_Irecv(&data[northin], ncount, northsouthedge, master->nnorth, 2, master->commxy, &master->reqs[master->reqsn]);
-            master->reqsn++;
-            master->wait_all();
+            MPI_Recv_init(&halorecv[offset[n]], offset[n+1]-offset[n], MPI_DOUBLE, nrecv[n], 11+n, master->commxy, &reqs[n]);
+            MPI_Send_init(&halosend[offset[n]], offset[n+1]-offset[n], MPI_DOUBLE, nsend[n], 11+n, master->commxy, &reqs[nedge+n]);
         }
-        // In case of 2D, fill all the ghost cells in the y-direction with the same value.
-        else
-        {
-            const int jj = icells;
-            const int kk = icells*jcells;
+    }
+
+    // Post the receives before the sends, one message per neighbor.
+    MPI_Startall(nedge, &reqs[0]);
+
+    for (int n=0; n<nedge; ++n)
+    {
+        const int blocksize = ni[n]*nj[n]*kcells;
+        for (int f=0; f<nfields; ++f)
+            pack_block(&halosend[offset[n] + f*blocksize], data[f], isend[n], jsend[n], ni[n], nj[n], kcells, icells, ijcells);
+    }
 
+    const double start = master->comm_start();
+    MPI_Startall(nedge, &reqs[nedge]);
+    wait_requests(reqs);
+    master->comm_stop(Comm_boundary_cyclic_multi, start, offset[nedge]*sizeof(double), nedge);
+
+    for (int n=0; n<nedge; ++n)
+    {
+        const int blocksize = ni[n]*nj[n]*kcells;
+        for (int f=0; f<nfields; ++f)
+            unpack_block(data[f], &halorecv[offset[n] + f*blocksize], irecv[n], jrecv[n], ni[n], nj[n], kcells, icells, ijcells);
+    }
+
+    // In case of 2D, fill all the ghost cells in the y-direction with the same value.
+    if (jtot == 1)
+    {
+        const int jj = icells;
+        const int kk = icells*jcells;
+
+        for (int f=0; f<nfields; ++f)
+        {
+            double* restrict fld = data[f];
             for (int k=kstart; k<kend; k++)
                 for (int j=0; j<jgc; j++)
 #pragma ivdep
@@ -235,8 +557,8 @@ void Grid::boundary_cyclic(double* restrict data, Edge edge)
                         const int ijkref   = i + jstart*jj   + k*kk;
                         const int ijknorth = i + j*jj        + k*kk;
                         const int ijksouth = i + (jend+j)*jj + k*kk;
-                        data[ijknorth] = data[ijkref];
-                        data[ijksouth] = data[ijkref];
+                        fld[ijknorth] = fld[ijkref];
+                        fld[ijksouth] = fld[ijkref];
                     }
         }
     }
@@ -259,30 +581,40 @@ void Grid::boundary_cyclic_2d(double* restrict data)
     int northin  = jend  *icells;
 
     // first, send and receive the ghost cells in east-west direction
-    MPI_Isend(&data[eastout], ncount, eastwestedge2d, master->neast, 1, master->commxy, &master->reqs[master->reqsn]);
-    master->reqsn++;
-    MPI_Irecv(&data[westin], ncount, eastwestedge2d, master->nwest, 1, master->commxy, &master->reqs[master->reqsn]);
-    master->reqsn++;
-    MPI_Isend(&data[westout], ncount, eastwestedge2d, master->nwest, 2, master->commxy, &master->reqs[master->reqsn]);
-    master->reqsn++;
-    MPI_Irecv(&data[eastin], ncount, eastwestedge2d, master->neast, 2, master->commxy, &master->reqs[master->reqsn]);
-    master->reqsn++;
+    std::vector<MPI_Request>& reqsew = get_requests(Halo_2d, East_west_edge, data, data);
+    if (reqsew.empty())
+    {
+        int nr = 0;
+        reqsew.resize(4);
+        MPI_Send_init(&data[eastout], ncount, eastwestedge2d, master->neast, 1, master->commxy, &reqsew[nr++]);
+        MPI_Recv_init(&data[westin], ncount, eastwestedge2d, master->nwest, 1, master->commxy, &reqsew[nr++]);
+        MPI_Send_init(&data[westout], ncount, eastwestedge2d, master->nwest, 2, master->commxy, &reqsew[nr++]);
+        MPI_Recv_init(&data[eastin], ncount, eastwestedge2d, master->neast, 2, master->commxy, &reqsew[nr++]);
+    }
+    double start = master->comm_start();
+    start_requests(reqsew);
     // wait here for the mpi to have correct values in the corners of the cells
-    master->wait_all();
+    wait_requests(reqsew);
+    master->comm_stop(Comm_boundary_cyclic_2d, start, 2.*type_bytes(eastwestedge2d), 2);
 
     // if the run is 3D, apply the BCs
     if (jtot > 1)
     {
         // second, send and receive the ghost cells in the north-south direction
-        MPI_Isend(&data[northout], ncount, northsouthedge2d, master->nnorth, 1, master->commxy, &master->reqs[master->reqsn]);
-        master->reqsn++;
-        MPI_Irecv(&data[southin], ncount, northsouthedge2d, master->nsouth, 1, master->commxy, &master->reqs[master->reqsn]);
-        master->reqsn++;
-        MPI_Isend(&data[southout], ncount, northsouthedge2d, master->nsouth, 2, master->commxy, &master->reqs[master->reqsn]);
-        master->reqsn++;
-        MPI_Irecv(&data[northin], ncount, northsouthedge2d, master->nnorth, 2, master->commxy, &master->reqs[master->reqsn]);
-        master->reqsn++;
-        master->wait_all();
+        std::vector<MPI_Request>& reqsns = get_requests(Halo_2d, North_south_edge, data, data);
+        if (reqsns.empty())
+        {
+            int nr = 0;
+            reqsns.resize(4);
+            MPI_Send_init(&data[northout], ncount, northsouthedge2d, master->nnorth, 1, master->commxy, &reqsns[nr++]);
+            MPI_Recv_init(&data[southin], ncount, northsouthedge2d, master->nsouth, 1, master->commxy, &reqsns[nr++]);
+            MPI_Send_init(&data[southout], ncount, northsouthedge2d, master->nsouth, 2, master->commxy, &reqsns[nr++]);
+            MPI_Recv_init(&data[northin], ncount, northsouthedge2d, master->nnorth, 2, master->commxy, &reqsns[nr++]);
+        }
+        start = master->comm_start();
+        start_requests(reqsns);
+        wait_requests(reqsns);
+        master->comm_stop(Comm_boundary_cyclic_2d, start, 2.*type_bytes(northsouthedge2d), 2);
     }
     // in case of 2D, fill all the ghost cells with the current value
     else
@@ -305,158 +637,437 @@ void Grid::boundary_cyclic_2d(double* restrict data)
 
 void Grid::transpose_zx(double* restrict ar, double* restrict as)
 {
+    if (alltoall_transpose)
+    {
+        transpose_alltoall(ar, as, master->commx, master->npx, Comm_transpose_zx, blockz, blockx);
+        return;
+    }
+
     const int ncount = 1;
     const int tag = 1;
 
     const int jj = imax;
     const int kk = imax*jmax;
 
-    for (int n=0; n<master->npx; n++)
+    // The requests are created at the first transpose of a pair of arrays and restarted afterwards.
+    std::vector<MPI_Request>& reqs = get_requests(Transpose_zx, 0, ar, as);
+    if (reqs.empty())
     {
-        // determine where to fetch the data and where to store it
-        const int ijks = n*kblock*kk;
-        const int ijkr = n*jj;
-
-        // send and receive the data
-        MPI_Isend(&as[ijks], ncount, transposez, n, tag, master->commx, &master->reqs[master->reqsn]);
-        master->reqsn++;
-        MPI_Irecv(&ar[ijkr], ncount, transposex, n, tag, master->commx, &master->reqs[master->reqsn]);
-        master->reqsn++;
+        reqs.resize(2*master->npx);
+        for (int n=0; n<master->npx; n++)
+        {
+            // determine where to fetch the data and where to store it
+            const int ijks = n*kblock*kk;
+            const int ijkr = n*jj;
+
+            // send and receive the data
+            MPI_Send_init(&as[ijks], ncount, transposez, n, tag, master->commx, &reqs[2*n  ]);
+            MPI_Recv_init(&ar[ijkr], ncount, transposex, n, tag, master->commx, &reqs[2*n+1]);
+        }
     }
-    master->wait_all();
+
+    const double start = master->comm_start();
+    start_requests(reqs);
+    wait_requests(reqs);
+    master->comm_stop(Comm_transpose_zx, start, master->npx*type_bytes(transposez), master->npx);
 }
 
 void Grid::transpose_xz(double* restrict ar, double* restrict as)
 {
+    if (alltoall_transpose)
+    {
+        transpose_alltoall(ar, as, master->commx, master->npx, Comm_transpose_xz, blockx, blockz);
+        return;
+    }
+
     const int ncount = 1;
     const int tag = 1;
 
     const int jj = imax;
     const int kk = imax*jmax;
 
-    for (int n=0; n<master->npx; n++)
+    // The requests are created at the first transpose of a pair of arrays and restarted afterwards.
+    std::vector<MPI_Request>& reqs = get_requests(Transpose_xz, 0, ar, as);
+    if (reqs.empty())
     {
-        // determine where to fetch the data and where to store it
-        const int ijks = n*jj;
-        const int ijkr = n*kblock*kk;
-
-        // send and receive the data
-        MPI_Isend(&as[ijks], ncount, transposex, n, tag, master->commx, &master->reqs[master->reqsn]);
-        master->reqsn++;
-        MPI_Irecv(&ar[ijkr], ncount, transposez, n, tag, master->commx, &master->reqs[master->reqsn]);
-        master->reqsn++;
+        reqs.resize(2*master->npx);
+        for (int n=0; n<master->npx; n++)
+        {
+            // determine where to fetch the data and where to store it
+            const int ijks = n*jj;
+            const int ijkr = n*kblock*kk;
+
+            // send and receive the data
+            MPI_Send_init(&as[ijks], ncount, transposex, n, tag, master->commx, &reqs[2*n  ]);
+            MPI_Recv_init(&ar[ijkr], ncount, transposez, n, tag, master->commx, &reqs[2*n+1]);
+        }
     }
-    master->wait_all();
+
+    const double start = master->comm_start();
+    start_requests(reqs);
+    wait_requests(reqs);
+    master->comm_stop(Comm_transpose_xz, start, master->npx*type_bytes(transposex), master->npx);
 }
 
 void Grid::transpose_xy(double* restrict ar, double* restrict as)
 {
+    if (alltoall_transpose)
+    {
+        transpose_alltoall(ar, as, master->commy, master->npy, Comm_transpose_xy, blockx2, blocky);
+        return;
+    }
+
     const int ncount = 1;
     const int tag = 1;
 
     const int jj = iblock;
     const int kk = iblock*jmax;
 
-    for (int n=0; n<master->npy; n++)
+    // The requests are created at the first transpose of a pair of arrays and restarted afterwards.
+    std::vector<MPI_Request>& reqs = get_requests(Transpose_xy, 0, ar, as);
+    if (reqs.empty())
     {
-        // determine where to fetch the data and where to store it
-        const int ijks = n*jj;
-        const int ijkr = n*kk;
-
-        // send and receive the data
-        MPI_Isend(&as[ijks], ncount, transposex2, n, tag, master->commy, &master->reqs[master->reqsn]);
-        master->reqsn++;
-        MPI_Irecv(&ar[ijkr], ncount, transposey , n, tag, master->commy, &master->reqs[master->reqsn]);
-        master->reqsn++;
+        reqs.resize(2*master->npy);
+        for (int n=0; n<master->npy; n++)
+        {
+            // determine where to fetch the data and where to store it
+            const int ijks = n*jj;
+            const int ijkr = n*kk;
+
+            // send and receive the data
+            MPI_Send_init(&as[ijks], ncount, transposex2, n, tag, master->commy, &reqs[2*n  ]);
+            MPI_Recv_init(&ar[ijkr], ncount, transposey , n, tag, master->commy, &reqs[2*n+1]);
+        }
     }
-    master->wait_all();
+
+    const double start = master->comm_start();
+    start_requests(reqs);
+    wait_requests(reqs);
+    master->comm_stop(Comm_transpose_xy, start, master->npy*type_bytes(transposex2), master->npy);
 }
 
 void Grid::transpose_yx(double* restrict ar, double* restrict as)
 {
+    if (alltoall_transpose)
+    {
+        transpose_alltoall(ar, as, master->commy, master->npy, Comm_transpose_yx, blocky, blockx2);
+        return;
+    }
+
     const int ncount = 1;
     const int tag = 1;
 
     const int jj = iblock;
     const int kk = iblock*jmax;
 
-    for (int n=0; n<master->npy; n++)
+    // The requests are created at the first transpose of a pair of arrays and restarted afterwards.
+    std::vector<MPI_Request>& reqs = get_requests(Transpose_yx, 0, ar, as);
+    if (reqs.empty())
     {
-        // determine where to fetch the data and where to store it
-        const int ijks = n*kk;
-        const int ijkr = n*jj;
-
-        // send and receive the data
-        MPI_Isend(&as[ijks], ncount, transposey , n, tag, master->commy, &master->reqs[master->reqsn]);
-        master->reqsn++;
-        MPI_Irecv(&ar[ijkr], ncount, transposex2, n, tag, master->commy, &master->reqs[master->reqsn]);
-        master->reqsn++;
+        reqs.resize(2*master->npy);
+        for (int n=0; n<master->npy; n++)
+        {
+            // determine where to fetch the data and where to store it
+            const int ijks = n*kk;
+            const int ijkr = n*jj;
+
+            // send and receive the data
+            MPI_Send_init(&as[ijks], ncount, transposey , n, tag, master->commy, &reqs[2*n  ]);
+            MPI_Recv_init(&ar[ijkr], ncount, transposex2, n, tag, master->commy, &reqs[2*n+1]);
+        }
     }
-    master->wait_all();
+
+    const double start = master->comm_start();
+    start_requests(reqs);
+    wait_requests(reqs);
+    master->comm_stop(Comm_transpose_yx, start, master->npy*type_bytes(transposey), master->npy);
 }
 
 void Grid::transpose_yz(double* restrict ar, double* restrict as)
 {
+    if (alltoall_transpose)
+    {
+        transpose_alltoall(ar, as, master->commx, master->npx, Comm_transpose_yz, blocky2, blockz2);
+        return;
+    }
+
     const int ncount = 1;
     const int tag = 1;
 
     const int jj = iblock;
     const int kk = iblock*jblock;
 
-    for (int n=0; n<master->npx; n++)
+    // The requests are created at the first transpose of a pair of arrays and restarted afterwards.
+    std::vector<MPI_Request>& reqs = get_requests(Transpose_yz, 0, ar, as);
+    if (reqs.empty())
     {
-        // determine where to fetch the data and where to store it
-        const int ijks = n*jblock*jj;
-        const int ijkr = n*kblock*kk;
-
-        // send and receive the data
-        MPI_Isend(&as[ijks], ncount, transposey2, n, tag, master->commx, &master->reqs[master->reqsn]);
-        master->reqsn++;
-        MPI_Irecv(&ar[ijkr], ncount, transposez2, n, tag, master->commx, &master->reqs[master->reqsn]);
-        master->reqsn++;
+        reqs.resize(2*master->npx);
+        for (int n=0; n<master->npx; n++)
+        {
+            // determine where to fetch the data and where to store it
+            const int ijks = n*jblock*jj;
+            const int ijkr = n*kblock*kk;
+
+            // send and receive the data
+            MPI_Send_init(&as[ijks], ncount, transposey2, n, tag, master->commx, &reqs[2*n  ]);
+            MPI_Recv_init(&ar[ijkr], ncount, transposez2, n, tag, master->commx, &reqs[2*n+1]);
+        }
     }
-    master->wait_all();
+
+    const double start = master->comm_start();
+    start_requests(reqs);
+    wait_requests(reqs);
+    master->comm_stop(Comm_transpose_yz, start, master->npx*type_bytes(transposey2), master->npx);
 }
 
 void Grid::transpose_zy(double* restrict ar, double* restrict as)
 {
+    if (alltoall_transpose)
+    {
+        transpose_alltoall(ar, as, master->commx, master->npx, Comm_transpose_zy, blockz2, blocky2);
+        return;
+    }
+
     const int ncount = 1;
     const int tag = 1;
 
     const int jj = iblock;
     const int kk = iblock*jblock;
 
-    for (int n=0; n<master->npx; n++)
+    // The requests are created at the first transpose of a pair of arrays and restarted afterwards.
+    std::vector<MPI_Request>& reqs = get_requests(Transpose_zy, 0, ar, as);
+    if (reqs.empty())
+    {
+        reqs.resize(2*master->npx);
+        for (int n=0; n<master->npx; n++)
+        {
+            // determine where to fetch the data and where to store it
+            const int ijks = n*kblock*kk;
+            const int ijkr = n*jblock*jj;
+
+            // send and receive the data
+            MPI_Send_init(&as[ijks], ncount, transposez2, n, tag, master->commx, &reqs[2*n  ]);
+            MPI_Recv_init(&ar[ijkr], ncount, transposey2, n, tag, master->commx, &reqs[2*n+1]);
+        }
+    }
+
+    const double start = master->comm_start();
+    start_requests(reqs);
+    wait_requests(reqs);
+    master->comm_stop(Comm_transpose_zy, start, master->npx*type_bytes(transposez2), master->npx);
+}
+
+void Grid::transpose_alltoall(double* restrict ar, const double* restrict as, MPI_Comm comm, int np, int site,
+                              const Transpose_block& sendblock, const Transpose_block& recvblock)
+{
+    // The blocks of all partners have the same size, thus a single MPI_Alltoall suffices.
+    const int blocksize = sendblock.ni*sendblock.nj*sendblock.nk;
+
+    if (static_cast<int>(transposesend.size()) < np*blocksize)
+    {
+        transposesend.resize(np*blocksize);
+        transposerecv.resize(np*blocksize);
+    }
+
+    // pack the blocks of all partners into a contiguous buffer
+    const Transpose_block& sb = sendblock;
+    for (int n=0; n<np; n++)
+    {
+        const int ijk0 = n*sb.di + n*sb.dj*sb.jj + n*sb.dk*sb.kk;
+        double* restrict buf = &transposesend[n*blocksize];
+        for (int k=0; k<sb.nk; k++)
+            for (int j=0; j<sb.nj; j++)
+#pragma ivdep
+                for (int i=0; i<sb.ni; i++)
+                    buf[i + j*sb.ni + k*sb.ni*sb.nj] = as[ijk0 + i + j*sb.jj + k*sb.kk];
+    }
+
+    const double start = master->comm_start();
+    MPI_Alltoall(&transposesend[0], blocksize, MPI_DOUBLE, &transposerecv[0], blocksize, MPI_DOUBLE, comm);
+    master->comm_stop(site, start, np*blocksize*sizeof(double), np);
+
+    // unpack the received blocks into their place in the new orientation
+    const Transpose_block& rb = recvblock;
+    for (int n=0; n<np; n++)
+    {
+        const int ijk0 = n*rb.di + n*rb.dj*rb.jj + n*rb.dk*rb.kk;
+        const double* restrict buf = &transposerecv[n*blocksize];
+        for (int k=0; k<rb.nk; k++)
+            for (int j=0; j<rb.nj; j++)
+#pragma ivdep
+                for (int i=0; i<rb.ni; i++)
+                    ar[ijk0 + i + j*rb.jj + k*rb.kk] = buf[i + j*rb.ni + k*rb.ni*rb.nj];
+    }
+}
+
+void Grid::tune_transposes()
+{
+    if (swtranspose != "auto")
     {
-        // determine where to fetch the data and where to store it
-        const int ijks = n*kblock*kk;
-        const int ijkr = n*jblock*jj;
-
-        // send and receive the data
-        MPI_Isend(&as[ijks], ncount, transposez2, n, tag, master->commx, &master->reqs[master->reqsn]);
-        master->reqsn++;
-        MPI_Irecv(&ar[ijkr], ncount, transposey2, n, tag, master->commx, &master->reqs[master->reqsn]);
-        master->reqsn++;
+        alltoall_transpose = (swtranspose == "alltoall");
+        return;
+    }
+
+    // time the complete cycle of transposes of the pressure solver for both backends
+    const int niter = 5;
+    std::vector<double> a(nmax, 0.);
+    std::vector<double> b(nmax, 0.);
+    double time[2];
+
+    for (int backend=0; backend<2; backend++)
+    {
+        alltoall_transpose = (backend == 1);
+
+        // the first cycle sets up the persistent requests and is not timed
+        for (int iter=0; iter<niter+1; iter++)
+        {
+            if (iter == 1)
+            {
+                MPI_Barrier(master->commxy);
+                time[backend] = master->get_wall_clock_time();
+            }
+            transpose_zx(&b[0], &a[0]);
+            transpose_xy(&a[0], &b[0]);
+            transpose_yz(&b[0], &a[0]);
+            transpose_zy(&a[0], &b[0]);
+            transpose_yx(&b[0], &a[0]);
+            transpose_xz(&a[0], &b[0]);
+        }
+        time[backend] = master->get_wall_clock_time() - time[backend];
+
+        // the slowest process determines the speed
+        master->max(&time[backend], 1);
     }
-    master->wait_all();
+
+    free_requests(&a[0]);
+    free_requests(&b[0]);
+
+    alltoall_transpose = (time[1] < time[0]);
+    swtranspose = alltoall_transpose ? "alltoall" : "p2p";
+
+    master->print_message("Transposes use %s (p2p: %E s, alltoall: %E s)\n", swtranspose.c_str(), time[0], time[1]);
+}
+
+std::vector<MPI_Request>& Grid::transpose_chunks_start(Comm_pattern pattern, double* restrict ar, double* restrict as)
+{
+    std::vector<MPI_Request>& reqs = get_requests(pattern, fftchunks, ar, as);
+
+    if (reqs.empty())
+    {
+        // Each message contains the levels of one chunk, the addresses of the first level
+        // follow from the offset per partner (dn) and per level (dk) in both orientations.
+        MPI_Comm comm;
+        MPI_Datatype sendtype, recvtype;
+        int np, senddn, senddk, recvdn, recvdk;
+
+        if (pattern == Transpose_zx_chunks)
+        {
+            comm = master->commx; np = master->npx;
+            sendtype = transposezlevel; senddn = kblock*imax*jmax; senddk = imax*jmax;
+            recvtype = transposexlevel; recvdn = imax;             recvdk = itot*jmax;
+        }
+        else if (pattern == Transpose_xy_chunks)
+        {
+            comm = master->commy; np = master->npy;
+            sendtype = transposex2level; senddn = iblock;      senddk = itot*jmax;
+            recvtype = transposeylevel;  recvdn = iblock*jmax; recvdk = iblock*jtot;
+        }
+        else if (pattern == Transpose_zy_chunks)
+        {
+            comm = master->commx; np = master->npx;
+            sendtype = transposez2level; senddn = kblock*iblock*jblock; senddk = iblock*jblock;
+            recvtype = transposey2level; recvdn = iblock*jblock;        recvdk = iblock*jtot;
+        }
+        else if (pattern == Transpose_yx_chunks)
+        {
+            comm = master->commy; np = master->npy;
+            sendtype = transposeylevel;  senddn = iblock*jmax; senddk = iblock*jtot;
+            recvtype = transposex2level; recvdn = iblock;      recvdk = itot*jmax;
+        }
+        else
+        {
+            master->print_error("Pattern %d cannot be transposed in chunks\n", pattern);
+            throw 1;
+        }
+
+        reqs.resize(2*np*fftchunks);
+
+        for (int c=0; c<fftchunks; c++)
+        {
+            const int k0 = c*kblock/fftchunks;
+            const int nk = (c+1)*kblock/fftchunks - k0;
+            const int tag = 100+c;
+
+            for (int n=0; n<np; n++)
+            {
+                const int ijks = n*senddn + k0*senddk;
+                const int ijkr = n*recvdn + k0*recvdk;
+
+                MPI_Send_init(&as[ijks], nk, sendtype, n, tag, comm, &reqs[2*(c*np+n)  ]);
+                MPI_Recv_init(&ar[ijkr], nk, recvtype, n, tag, comm, &reqs[2*(c*np+n)+1]);
+            }
+        }
+    }
+
+    // All chunks together send the same volume as the transpose without chunks.
+    const double start = master->comm_start();
+    start_requests(reqs);
+
+    const int site = chunk_site(pattern);
+    if (site == Comm_transpose_zx)
+        master->comm_stop(site, start, master->npx*type_bytes(transposez ), master->npx*fftchunks);
+    else if (site == Comm_transpose_xy)
+        master->comm_stop(site, start, master->npy*type_bytes(transposex2), master->npy*fftchunks);
+    else if (site == Comm_transpose_zy)
+        master->comm_stop(site, start, master->npx*type_bytes(transposez2), master->npx*fftchunks);
+    else
+        master->comm_stop(site, start, master->npy*type_bytes(transposey ), master->npy*fftchunks);
+
+    return reqs;
+}
+
+void Grid::transpose_chunk_wait(Comm_pattern pattern, std::vector<MPI_Request>& reqs, int chunk)
+{
+    const double start = master->comm_start();
+    const int nreqs = reqs.size()/fftchunks;
+    MPI_Waitall(nreqs, &reqs[chunk*nreqs], MPI_STATUSES_IGNORE);
+    master->comm_stop(chunk_site(pattern), start, 0., 0);
+}
+
+int Grid::chunk_site(Comm_pattern pattern)
+{
+    if (pattern == Transpose_zx_chunks)
+        return Comm_transpose_zx;
+    else if (pattern == Transpose_xy_chunks)
+        return Comm_transpose_xy;
+    else if (pattern == Transpose_zy_chunks)
+        return Comm_transpose_zy;
+    else
+        return Comm_transpose_yx;
 }
 
 void Grid::get_max(double *var)
 {
     double varl = *var;
+    const double start = master->comm_start();
     MPI_Allreduce(&varl, var, 1, MPI_DOUBLE, MPI_MAX, master->commxy);
+    master->comm_stop(Comm_grid_get_max, start, sizeof(double), 1);
 }
 
 void Grid::get_max(int *var)
 {
     int varl = *var;
+    const double start = master->comm_start();
     MPI_Allreduce(&varl, var, 1, MPI_INT, MPI_MAX, master->commxy);
+    master->comm_stop(Comm_grid_get_max, start, sizeof(int), 1);
 }
 
 void Grid::get_sum(double *var)
 {
     double varl = *var;
+    const double start = master->comm_start();
     MPI_Allreduce(&varl, var, 1, MPI_DOUBLE, MPI_SUM, master->commxy);
+    master->comm_stop(Comm_grid_get_sum, start, sizeof(double), 1);
 }
 
 void Grid::get_prof(double *prof, int kcellsin)
@@ -464,7 +1075,9 @@ void Grid::get_prof(double *prof, int kcellsin)
     for (int k=0; k<kcellsin; k++)
         profl[k] = prof[k] / master->nprocs;
 
+    const double start = master->comm_start();
     MPI_Allreduce(profl, prof, kcellsin, MPI_DOUBLE, MPI_SUM, master->commxy);
+    master->comm_stop(Comm_grid_get_prof, start, kcellsin*sizeof(double), 1);
 }
 
 // IO functions
@@ -525,28 +1138,7 @@ void Grid::save()
     master->print_message("OK\n");
 
     // SAVE THE FFTW PLAN IN ORDER TO ENSURE BITWISE IDENTICAL RESTARTS
-    // use the FFTW3 many interface in order to reduce function call overhead
-    int rank = 1;
-    int ni[] = {itot};
-    int nj[] = {jtot};
-    int istride = 1;
-    int jstride = iblock;
-    int idist = itot;
-    int jdist = 1;
-
-    fftw_r2r_kind kindf[] = {FFTW_R2HC};
-    fftw_r2r_kind kindb[] = {FFTW_HC2R};
-
-    iplanf = fftw_plan_many_r2r(rank, ni, jmax, fftini, ni, istride, idist,
-                                fftouti, ni, istride, idist, kindf, FFTW_EXHAUSTIVE);
-    iplanb = fftw_plan_many_r2r(rank, ni, jmax, fftini, ni, istride, idist,
-                                fftouti, ni, istride, idist, kindb, FFTW_EXHAUSTIVE);
-    jplanf = fftw_plan_many_r2r(rank, nj, iblock, fftinj, nj, jstride, jdist,
-                                fftoutj, nj, jstride, jdist, kindf, FFTW_EXHAUSTIVE);
-    jplanb = fftw_plan_many_r2r(rank, nj, iblock, fftinj, nj, jstride, jdist,
-                                fftoutj, nj, jstride, jdist, kindb, FFTW_EXHAUSTIVE);
-
-    fftwplan = true;
+    create_fft_plans();
 
     if (master->mpiid == 0)
     {
@@ -623,26 +1215,7 @@ void Grid::load()
     else
         master->print_message("OK\n");
 
-    // use the FFTW3 many interface in order to reduce function call overhead
-    int rank = 1;
-    int ni[] = {itot};
-    int nj[] = {jtot};
-    int istride = 1;
-    int jstride = iblock;
-    int idist = itot;
-    int jdist = 1;
-    fftw_r2r_kind kindf[] = {FFTW_R2HC};
-    fftw_r2r_kind kindb[] = {FFTW_HC2R};
-    iplanf = fftw_plan_many_r2r(rank, ni, jmax, fftini, ni, istride, idist,
-                                fftouti, ni, istride, idist, kindf, FFTW_EXHAUSTIVE);
-    iplanb = fftw_plan_many_r2r(rank, ni, jmax, fftini, ni, istride, idist,
-                                fftouti, ni, istride, idist, kindb, FFTW_EXHAUSTIVE);
-    jplanf = fftw_plan_many_r2r(rank, nj, iblock, fftinj, nj, jstride, jdist,
-                                fftoutj, nj, jstride, jdist, kindf, FFTW_EXHAUSTIVE);
-    jplanb = fftw_plan_many_r2r(rank, nj, iblock, fftinj, nj, jstride, jdist,
-                                fftoutj, nj, jstride, jdist, kindb, FFTW_EXHAUSTIVE);
-
-    fftwplan = true;
+    create_fft_plans();
 
     fftw_forget_wisdom();
 }
@@ -741,59 +1314,46 @@ void Grid::fft_forward(double* restrict data,   double* restrict tmp1,
                        double* restrict fftini, double* restrict fftouti,
                        double* restrict fftinj, double* restrict fftoutj)
 {
+    // The transposes to x and y are split in chunks of levels, such that the fourier transforms of one
+    // chunk are computed while the next chunks are communicated. The alltoall transposes are not split.
+    const bool pipeline = !alltoall_transpose && fftchunks > 1;
+    const int nk = kblock/fftchunks;
+
     // transpose the pressure field
-    transpose_zx(tmp1,data);
+    std::vector<MPI_Request>* reqs = 0;
+    if (pipeline)
+        reqs = &transpose_chunks_start(Transpose_zx_chunks, tmp1, data);
+    else
+        transpose_zx(tmp1,data);
 
     int kk = itot*jmax;
 
-    // process the fourier transforms slice by slice
-    for (int k=0; k<kblock; k++)
+    // process the fourier transforms chunk by chunk
+    for (int c=0; c<fftchunks; c++)
     {
-#pragma ivdep
-        for (int n=0; n<itot*jmax; n++)
-        {
-            const int ij  = n;
-            const int ijk = n + k*kk;
-            fftini[ij] = tmp1[ijk];
-        }
+        if (pipeline)
+            transpose_chunk_wait(Transpose_zx_chunks, *reqs, c);
 
-        fftw_execute(iplanf);
-
-#pragma ivdep
-        for (int n=0; n<itot*jmax; n++)
-        {
-            const int ij  = n;
-            const int ijk = n + k*kk;
-            tmp1[ijk] = fftouti[ij];
-        }
+        const int ijk = c*nk*kk;
+        fft_block(iplanfblock, iplanf, &tmp1[ijk], &tmp1[ijk], fftini, fftouti, nk, kk, 1.);
     }
 
     // transpose again
-    transpose_xy(data,tmp1);
+    if (pipeline)
+        reqs = &transpose_chunks_start(Transpose_xy_chunks, data, tmp1);
+    else
+        transpose_xy(data,tmp1);
 
     kk = iblock*jtot;
 
     // do the second fourier transform
-    for (int k=0; k<kblock; k++)
+    for (int c=0; c<fftchunks; c++)
     {
-#pragma ivdep
-        for (int n=0; n<iblock*jtot; n++)
-        {
-            const int ij  = n;
-            const int ijk = n + k*kk;
-            fftinj[ij] = data[ijk];
-        }
+        if (pipeline)
+            transpose_chunk_wait(Transpose_xy_chunks, *reqs, c);
 
-        fftw_execute(jplanf);
-
-#pragma ivdep
-        for (int n=0; n<iblock*jtot; n++)
-        {
-            const int ij  = n;
-            const int ijk = n + k*kk;
-            // shift to use p in pressure solver
-            tmp1[ijk] = fftoutj[ij];
-        }
+        const int ijk = c*nk*kk;
+        fft_block(jplanfblock, jplanf, &data[ijk], &tmp1[ijk], fftinj, fftoutj, nk, kk, 1.);
     }
 
     // transpose back to original orientation
@@ -804,59 +1364,44 @@ void Grid::fft_backward(double* restrict data,   double* restrict tmp1,
                         double* restrict fftini, double* restrict fftouti,
                         double* restrict fftinj, double* restrict fftoutj)
 {
+    const bool pipeline = !alltoall_transpose && fftchunks > 1;
+    const int nk = kblock/fftchunks;
+
     // transpose back to y
-    transpose_zy(tmp1, data);
+    std::vector<MPI_Request>* reqs = 0;
+    if (pipeline)
+        reqs = &transpose_chunks_start(Transpose_zy_chunks, tmp1, data);
+    else
+        transpose_zy(tmp1, data);
 
     int kk = iblock*jtot;
 
-    // transform the second transform back
-    for (int k=0; k<kblock; k++)
+    // transform the second transform back, keep the data in place, as data is still being sent in the other chunks
+    for (int c=0; c<fftchunks; c++)
     {
-#pragma ivdep
-        for (int n=0; n<iblock*jtot; n++)
-        {
-            const int ij  = n;
-            const int ijk = n + k*kk;
-            fftinj[ij] = tmp1[ijk];
-        }
+        if (pipeline)
+            transpose_chunk_wait(Transpose_zy_chunks, *reqs, c);
 
-        fftw_execute(jplanb);
-
-#pragma ivdep
-        for (int n=0; n<iblock*jtot; n++)
-        {
-            const int ij  = n;
-            const int ijk = n + k*kk;
-            data[ijk] = fftoutj[ij] / jtot;
-        }
+        const int ijk = c*nk*kk;
+        fft_block(jplanbblock, jplanb, &tmp1[ijk], &tmp1[ijk], fftinj, fftoutj, nk, kk, jtot);
     }
 
     // transpose back to x
-    transpose_yx(tmp1, data);
+    if (pipeline)
+        reqs = &transpose_chunks_start(Transpose_yx_chunks, data, tmp1);
+    else
+        transpose_yx(data, tmp1);
 
     kk = itot*jmax;
 
     // transform the first transform back
-    for (int k=0; k<kblock; k++)
+    for (int c=0; c<fftchunks; c++)
     {
-#pragma ivdep
-        for (int n=0; n<itot*jmax; n++)
-        {
-            const int ij  = n;
-            const int ijk = n + k*kk;
-            fftini[ij] = tmp1[ijk];
-        }
-
-        fftw_execute(iplanb);
+        if (pipeline)
+            transpose_chunk_wait(Transpose_yx_chunks, *reqs, c);
 
-#pragma ivdep
-        for (int n=0; n<itot*jmax; n++)
-        {
-            const int ij  = n;
-            const int ijk = n + k*kk;
-            // swap array here to avoid unnecessary 3d loop
-            data[ijk] = fftouti[ij] / itot;
-        }
+        const int ijk = c*nk*kk;
+        fft_block(iplanbblock, iplanb, &data[ijk], &data[ijk], fftini, fftouti, nk, kk, itot);
     }
 
     // and transpose back...
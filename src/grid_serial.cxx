@@ -110,6 +110,22 @@ void Grid::boundary_cyclic(double* restrict data, Edge edge)
     }
 }
 
+void Grid::boundary_cyclic(const std::vector<double*>& data)
+{
+    for (std::vector<double*>::const_iterator it=data.begin(); it!=data.end(); ++it)
+        boundary_cyclic(*it);
+}
+
+// Without MPI there is no communication to overlap, so the ghost cells are filled directly.
+void Grid::boundary_cyclic_start(double* restrict data, Edge edge)
+{
+    boundary_cyclic(data, edge);
+}
+
+void Grid::boundary_cyclic_finish(double* restrict data, Edge edge)
+{
+}
+
 void Grid::boundary_cyclic_2d(double* restrict data)
 {
     const int jj = icells;
@@ -304,26 +320,7 @@ void Grid::save()
     fclose(pFile);
 
     // SAVE THE FFTW PLAN IN ORDER TO ENSURE BITWISE IDENTICAL RESTARTS
-    // use the FFTW3 many interface in order to reduce function call overhead
-    int rank = 1;
-    int ni[] = {itot};
-    int nj[] = {jtot};
-    int istride = 1;
-    int jstride = iblock;
-    int idist = itot;
-    int jdist = 1;
-    fftw_r2r_kind kindf[] = {FFTW_R2HC};
-    fftw_r2r_kind kindb[] = {FFTW_HC2R};
-    iplanf = fftw_plan_many_r2r(rank, ni, jmax, fftini, ni, istride, idist,
-                                fftouti, ni, istride, idist, kindf, FFTW_EXHAUSTIVE);
-    iplanb = fftw_plan_many_r2r(rank, ni, jmax, fftini, ni, istride, idist,
-                                fftouti, ni, istride, idist, kindb, FFTW_EXHAUSTIVE);
-    jplanf = fftw_plan_many_r2r(rank, nj, iblock, fftinj, nj, jstride, jdist,
-                                fftoutj, nj, jstride, jdist, kindf, FFTW_EXHAUSTIVE);
-    jplanb = fftw_plan_many_r2r(rank, nj, iblock, fftinj, nj, jstride, jdist,
-                                fftoutj, nj, jstride, jdist, kindb, FFTW_EXHAUSTIVE);
-
-    fftwplan = true;
+    create_fft_plans();
 
     if (master->mpiid == 0)
     {
@@ -385,26 +382,7 @@ void Grid::load()
     else
         master->print_message("OK\n");
 
-    // use the FFTW3 many interface in order to reduce function call overhead
-    int rank = 1;
-    int ni[] = {itot};
-    int nj[] = {jtot};
-    int istride = 1;
-    int jstride = iblock;
-    int idist = itot;
-    int jdist = 1;
-    fftw_r2r_kind kindf[] = {FFTW_R2HC};
-    fftw_r2r_kind kindb[] = {FFTW_HC2R};
-    iplanf = fftw_plan_many_r2r(rank, ni, jmax, fftini, ni, istride, idist,
-            fftouti, ni, istride, idist, kindf, FFTW_EXHAUSTIVE);
-    iplanb = fftw_plan_many_r2r(rank, ni, jmax, fftini, ni, istride, idist,
-            fftouti, ni, istride, idist, kindb, FFTW_EXHAUSTIVE);
-    jplanf = fftw_plan_many_r2r(rank, nj, iblock, fftinj, nj, jstride, jdist,
-            fftoutj, nj, jstride, jdist, kindf, FFTW_EXHAUSTIVE);
-    jplanb = fftw_plan_many_r2r(rank, nj, iblock, fftinj, nj, jstride, jdist,
-            fftoutj, nj, jstride, jdist, kindb, FFTW_EXHAUSTIVE);
-
-    fftwplan = true;
+    create_fft_plans();
 
     fftw_forget_wisdom();
 }
@@ -479,53 +457,24 @@ void Grid::fft_forward(double* restrict data,   double* restrict tmp1,
                        double* restrict fftini, double* restrict fftouti,
                        double* restrict fftinj, double* restrict fftoutj)
 {
+    const int nk = kblock/fftchunks;
+
     int kk = itot*jmax;
 
-    // process the fourier transforms slice by slice
-    for (int k=0; k<kblock; k++)
+    // process the fourier transforms chunk by chunk
+    for (int c=0; c<fftchunks; c++)
     {
-#pragma ivdep
-        for (int n=0; n<itot*jmax; n++)
-        {
-            const int ij  = n;
-            const int ijk = n + k*kk;
-            fftini[ij] = data[ijk];
-        }
-
-        fftw_execute(iplanf);
-
-#pragma ivdep
-        for (int n=0; n<itot*jmax; n++)
-        {
-            const int ij  = n;
-            const int ijk = n + k*kk;
-            data[ijk] = fftouti[ij];
-        }
+        const int ijk = c*nk*kk;
+        fft_block(iplanfblock, iplanf, &data[ijk], &data[ijk], fftini, fftouti, nk, kk, 1.);
     }
 
     kk = iblock*jtot;
 
     // do the second fourier transform
-    for (int k=0; k<kblock; k++)
+    for (int c=0; c<fftchunks; c++)
     {
-#pragma ivdep
-        for (int n=0; n<iblock*jtot; n++)
-        {
-            const int ij  = n;
-            const int ijk = n + k*kk;
-            fftinj[ij] = data[ijk];
-        }
-
-        fftw_execute(jplanf);
-
-#pragma ivdep
-        for (int n=0; n<iblock*jtot; n++)
-        {
-            const int ij  = n;
-            const int ijk = n + k*kk;
-            // shift to use p in pressure solver
-            data[ijk] = fftoutj[ij];
-        }
+        const int ijk = c*nk*kk;
+        fft_block(jplanfblock, jplanf, &data[ijk], &data[ijk], fftinj, fftoutj, nk, kk, 1.);
     }
 }
 
@@ -533,53 +482,24 @@ void Grid::fft_backward(double* restrict data,   double* restrict tmp1,
                         double* restrict fftini, double* restrict fftouti,
                         double* restrict fftinj, double* restrict fftoutj)
 {
+    const int nk = kblock/fftchunks;
+
     int kk = iblock*jtot;
 
     // transform the second transform back
-    for (int k=0; k<kblock; k++)
+    for (int c=0; c<fftchunks; c++)
     {
-#pragma ivdep
-        for (int n=0; n<iblock*jtot; n++)
-        {
-            const int ij  = n;
-            const int ijk = n + k*kk;
-            fftinj[ij] = data[ijk];
-        }
-
-        fftw_execute(jplanb);
-
-#pragma ivdep
-        for (int n=0; n<iblock*jtot; n++)
-        {
-            const int ij  = n;
-            const int ijk = n + k*kk;
-            data[ijk] = fftoutj[ij] / jtot;
-        }
+        const int ijk = c*nk*kk;
+        fft_block(jplanbblock, jplanb, &data[ijk], &data[ijk], fftinj, fftoutj, nk, kk, jtot);
     }
 
     kk = itot*jmax;
 
-    // transform the first transform back
-    for (int k=0; k<kblock; k++)
+    // transform the first transform back, swap array here to avoid unnecessary 3d loop
+    for (int c=0; c<fftchunks; c++)
     {
-#pragma ivdep
-        for (int n=0; n<itot*jmax; n++)
-        {
-            const int ij  = n;
-            const int ijk = n + k*kk;
-            fftini[ij] = data[ijk];
-        }
-
-        fftw_execute(iplanb);
-
-#pragma ivdep
-        for (int n=0; n<itot*jmax; n++)
-        {
-            const int ij  = n;
-            const int ijk = n + k*kk;
-            // swap array here to avoid unnecessary 3d loop
-            tmp1[ijk] = fftouti[ij] / itot;
-        }
+        const int ijk = c*nk*kk;
+        fft_block(iplanbblock, iplanb, &data[ijk], &tmp1[ijk], fftini, fftouti, nk, kk, itot);
     }
 }
 
@@ -33,9 +33,14 @@
 #include <sstream>
 
 // Public functions
-Input::Input(Master* masterin)
+Input::Input(Master* masterin, bool readfiles)
 {
     master = masterin;
+    quiet = false;
+
+    // Without files, the items and profiles are provided via set_item and set_prof.
+    if (!readfiles)
+        return;
 
     const bool required = false;
     const bool optional = true;
@@ -59,6 +64,20 @@ void Input::clear()
     proflist.clear();
 }
 
+void Input::set_item(std::string cat, std::string item, std::string el, std::string value)
+{
+    if (el.empty())
+        el = "default";
+
+    inputlist[cat][item][el].data   = value;
+    inputlist[cat][item][el].isused = false;
+}
+
+void Input::set_prof(std::string varname, const std::vector<double>& data)
+{
+    proflist[varname] = data;
+}
+
 // Private functions
 int Input::read_ini_file()
 {
@@ -475,7 +494,7 @@ int Input::parse_item(valuetype* value, std::string cat, std::string item, std::
             itemtype = "(global)";
         }
     }
-    if (master->mpiid == 0) 
+    if (master->mpiid == 0 && !quiet)
         std::cout << std::left  << std::setw(30) << itemout << "= " 
             << std::right << std::setw(11) << std::setprecision(5) << std::boolalpha << *value 
             << "   " << itemtype << std::endl;
@@ -712,7 +731,7 @@ int Input::parse_list(std::vector<valuetype>* value, std::string cat, std::strin
     itemout = "[" + cat + "][" + item + "]";
     if (check_item_exists(cat, item))
     {
-        if (master->mpiid == 0)
+        if (master->mpiid == 0 && !quiet)
             std::cout << std::left  << std::setw(30) << itemout << "= "
                 << std::right << std::setw(11) << "EMPTY LIST" << std::endl;
     }
@@ -726,7 +745,7 @@ int Input::parse_list(std::vector<valuetype>* value, std::string cat, std::strin
             liststream << *it << ", ";
         }
         liststream << *(value->end()-1);
-        if (master->mpiid == 0)
+        if (master->mpiid == 0 && !quiet)
             std::cout << std::left  << std::setw(30) << itemout << "= "
                 << std::right << std::setw(11) << liststream.str() << std::endl;
     }
@@ -1039,3 +1058,8 @@ void Input::flag_as_used(std::string cat, std::string item)
         }
     }
 }
+
+void Input::set_quiet(bool quietin)
+{
+    quiet = quietin;
+}
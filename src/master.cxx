@@ -22,6 +22,10 @@
 
 #include <cstdarg>
 #include <cstdio>
+#include <vector>
+#ifdef USEOMP
+#include <omp.h>
+#endif
 #include "master.h"
 
 void Master::print_message(const char *format, ...)
@@ -77,3 +81,122 @@ bool Master::at_wall_clock_limit()
     else
         return false;
 }
+
+void Master::init_threads()
+{
+    if (nthreads < 1)
+    {
+        print_error("nthreads = %d has to be at least 1\n", nthreads);
+        throw 1;
+    }
+
+#ifdef USEOMP
+    omp_set_num_threads(nthreads);
+#else
+    if (nthreads > 1)
+    {
+        print_error("nthreads = %d requires a build with USEOMP enabled\n", nthreads);
+        throw 1;
+    }
+#endif
+
+    print_message("Running with %d threads per process\n", nthreads);
+}
+
+void Master::init_comm_profile()
+{
+    if (swcommprofile != "0" && swcommprofile != "1")
+    {
+        print_error("\"%s\" is an illegal value for swcommprofile\n", swcommprofile.c_str());
+        throw 1;
+    }
+
+    comm_time    .assign(Ncomm_sites, 0.);
+    comm_bytes   .assign(Ncomm_sites, 0.);
+    comm_messages.assign(Ncomm_sites, 0.);
+    comm_calls   .assign(Ncomm_sites, 0.);
+
+    comm_paused = false;
+}
+
+// Returns the time at the start of a communication, or zero if the profiler is disabled.
+double Master::comm_start()
+{
+    if (swcommprofile == "1" && !comm_paused)
+        return get_wall_clock_time();
+    else
+        return 0.;
+}
+
+// Adds the time since the start, the sent bytes and messages to a call site. Only calls
+// that send messages are counted, such that waiting for earlier started requests adds time only.
+void Master::comm_stop(const int site, const double start, const double bytes, const int nmessages)
+{
+    if (swcommprofile != "1" || comm_paused)
+        return;
+
+    comm_time    [site] += get_wall_clock_time() - start;
+    comm_bytes   [site] += bytes;
+    comm_messages[site] += nmessages;
+    if (nmessages > 0)
+        comm_calls[site] += 1.;
+}
+
+// Stops counting the communication, such that the reductions of the diagnostics are not counted.
+void Master::pause_comm_profile()
+{
+    comm_paused = true;
+}
+
+void Master::resume_comm_profile()
+{
+    comm_paused = false;
+}
+
+void Master::print_comm_profile()
+{
+    if (swcommprofile != "1")
+        return;
+
+    const char* names[Ncomm_sites] = {
+        "boundary_cyclic", "boundary_cyclic_multi", "boundary_cyclic_2d",
+        "transpose_zx", "transpose_xz", "transpose_xy",
+        "transpose_yx", "transpose_yz", "transpose_zy",
+        "master_sum", "master_max", "master_min",
+        "grid_get_max", "grid_get_sum", "grid_get_prof"};
+
+    // Pause the profiler, such that the reductions of the report are not counted.
+    pause_comm_profile();
+
+    std::vector<double> tmin(comm_time);
+    std::vector<double> tmax(comm_time);
+    std::vector<double> tsum(comm_time);
+    std::vector<double> bsum(comm_bytes);
+    std::vector<double> msum(comm_messages);
+    std::vector<double> bmax(comm_bytes);
+    std::vector<double> cmax(comm_calls);
+
+    min(tmin.data(), Ncomm_sites);
+    max(tmax.data(), Ncomm_sites);
+    sum(tsum.data(), Ncomm_sites);
+    sum(bsum.data(), Ncomm_sites);
+    sum(msum.data(), Ncomm_sites);
+    max(bmax.data(), Ncomm_sites);
+    max(cmax.data(), Ncomm_sites);
+
+    print_message("Communication profile over %d processes, times in s, volumes in MB\n", nprocs);
+    print_message("%-22s %9s %10s %11s %11s %11s %11s %11s\n",
+                  "SITE", "CALLS", "MESSAGES", "VOLUME", "MAXVOLUME", "MINTIME", "MEANTIME", "MAXTIME");
+
+    for (int n=0; n<Ncomm_sites; ++n)
+    {
+        if (tsum[n] == 0. && msum[n] == 0.)
+            continue;
+
+        print_message("%-22s %9.0f %10.0f %11.4E %11.4E %11.4E %11.4E %11.4E\n",
+                      names[n], cmax[n], msum[n], bsum[n]*1.e-6, bmax[n]*1.e-6,
+                      tmin[n], tsum[n]/nprocs, tmax[n]);
+    }
+
+    resume_comm_profile();
+}
@@ -40,7 +40,6 @@ Master::~Master()
 {
     if (allocated)
     {
-        delete[] reqs;
         MPI_Comm_free(&commxy);
         MPI_Comm_free(&commx);
         MPI_Comm_free(&commy);
@@ -55,9 +54,16 @@ Master::~Master()
 void Master::start(int argc, char *argv[])
 {
     // initialize the MPI
-    int n = MPI_Init(NULL, NULL);
+    // only the master thread communicates, the threads work on the kernels or write the statistics
+    int provided;
+    int n = MPI_Init_thread(NULL, NULL, MPI_THREAD_FUNNELED, &provided);
     if (check_error(n))
         throw 1;
+    if (provided < MPI_THREAD_FUNNELED)
+    {
+        print_error("MPI library does not provide MPI_THREAD_FUNNELED\n");
+        throw 1;
+    }
 
     wall_clock_start = get_wall_clock_time();
 
@@ -108,6 +114,8 @@ void Master::init(Input *inputin)
     int nerror = 0;
     nerror += inputin->get_item(&npx, "master", "npx", "", 1);
     nerror += inputin->get_item(&npy, "master", "npy", "", 1);
+    nerror += inputin->get_item(&nthreads, "master", "nthreads", "", 1);
+    nerror += inputin->get_item(&swcommprofile, "master", "swcommprofile", "", "0");
 
     // Get the wall clock limit with a default value of 1E8 hours, which will be never hit
     double wall_clock_limit;
@@ -124,6 +132,9 @@ void Master::init(Input *inputin)
         throw 1;
     }
 
+    init_threads();
+    init_comm_profile();
+
     int n;
     int dims    [2] = {npy, npx};
     int periodic[2] = {true, true};
@@ -177,14 +188,28 @@ void Master::init(Input *inputin)
     if (check_error(n))
         throw 1;
 
-    // create the requests arrays for the nonblocking sends
-    int npmax;
-    npmax = std::max(npx, npy);
+    // the diagonal neighbors are needed to fill the corner ghost cells in a single exchange
+    // the grid is periodic, so coordinates out of range are wrapped around
+    int ncoords[2];
+    ncoords[0] = mpicoordy+1; ncoords[1] = mpicoordx+1;
+    n = MPI_Cart_rank(commxy, ncoords, &nnortheast);
+    if (check_error(n))
+        throw 1;
 
-    // have at least as many communicators as prognostic variables
-    npmax = std::max(npmax, 8*4);
-    reqs  = new MPI_Request[npmax*2];
-    reqsn = 0;
+    ncoords[0] = mpicoordy+1; ncoords[1] = mpicoordx-1;
+    n = MPI_Cart_rank(commxy, ncoords, &nnorthwest);
+    if (check_error(n))
+        throw 1;
+
+    ncoords[0] = mpicoordy-1; ncoords[1] = mpicoordx+1;
+    n = MPI_Cart_rank(commxy, ncoords, &nsoutheast);
+    if (check_error(n))
+        throw 1;
+
+    ncoords[0] = mpicoordy-1; ncoords[1] = mpicoordx-1;
+    n = MPI_Cart_rank(commxy, ncoords, &nsouthwest);
+    if (check_error(n))
+        throw 1;
 
     allocated = true;
 }
@@ -209,13 +234,6 @@ int Master::check_error(int n)
     return 0;
 }
 
-void Master::wait_all()
-{
-    // wait for MPI processes and reset the number of pending requests
-    MPI_Waitall(reqsn, reqs, MPI_STATUSES_IGNORE);
-    reqsn = 0;
-}
-
 // do all broadcasts over the MPI_COMM_WORLD, to avoid complications in the input file reading
 void Master::broadcast(char *data, int datasize)
 {
@@ -240,21 +258,29 @@ void Master::broadcast(double *data, int datasize)
 
 void Master::sum(int *var, int datasize)
 {
+    const double start = comm_start();
     MPI_Allreduce(MPI_IN_PLACE, var, datasize, MPI_INT, MPI_SUM, commxy);
+    comm_stop(Comm_master_sum, start, datasize*sizeof(int), 1);
 }
 
 void Master::sum(double *var, int datasize)
 {
+    const double start = comm_start();
     MPI_Allreduce(MPI_IN_PLACE, var, datasize, MPI_DOUBLE, MPI_SUM, commxy);
+    comm_stop(Comm_master_sum, start, datasize*sizeof(double), 1);
 }
 
 void Master::max(double *var, int datasize)
 {
+    const double start = comm_start();
     MPI_Allreduce(MPI_IN_PLACE, var, datasize, MPI_DOUBLE, MPI_MAX, commxy);
+    comm_stop(Comm_master_max, start, datasize*sizeof(double), 1);
 }
 
 void Master::min(double *var, int datasize)
 {
+    const double start = comm_start();
     MPI_Allreduce(MPI_IN_PLACE, var, datasize, MPI_DOUBLE, MPI_MIN, commxy);
+    comm_stop(Comm_master_min, start, datasize*sizeof(double), 1);
 }
 #endif
@@ -79,6 +79,8 @@ void Master::init(Input *inputin)
     int nerror = 0;
     nerror += inputin->get_item(&npx, "master", "npx", "", 1);
     nerror += inputin->get_item(&npy, "master", "npy", "", 1);
+    nerror += inputin->get_item(&nthreads, "master", "nthreads", "", 1);
+    nerror += inputin->get_item(&swcommprofile, "master", "swcommprofile", "", "0");
 
     // Get the wall clock limit with a default value of 1E8 hours, which will be never hit
     double wall_clock_limit;
@@ -95,6 +97,9 @@ void Master::init(Input *inputin)
         throw 1;
     }
 
+    init_threads();
+    init_comm_profile();
+
     // set the coordinates to 0
     mpicoordx = 0;
     mpicoordy = 0;
@@ -109,10 +114,6 @@ double Master::get_wall_clock_time()
     return (double)timestruct.tv_sec + (double)timestruct.tv_usec*1.e-6;
 }
 
-void  Master::wait_all()
-{
-}
-
 // all broadcasts return directly, because there is nothing to broadcast
 void Master::broadcast(char *data, int datasize)
 {
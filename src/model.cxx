@@ -40,6 +40,7 @@
 #include "cross.h"
 #include "dump.h"
 #include "budget.h"
+#include "timing.h"
 
 #ifdef USECUDA
 #include <cuda_runtime_api.h>
@@ -65,6 +66,7 @@ Model::Model(Master *masterin, Input *inputin)
     cross  = 0;
     dump   = 0;
     budget = 0;
+    timing = 0;
 
     try
     {
@@ -92,6 +94,8 @@ Model::Model(Master *masterin, Input *inputin)
 
         budget = Budget::factory(input, master, grid, fields, thermo, diff, advec, force, stats);
 
+        timing = new Timing(this, input);
+
         // Get the list of masks.
         // TODO Make an interface that takes this out of the main loop.
         int nerror = 0;
@@ -129,6 +133,7 @@ Model::Model(Master *masterin, Input *inputin)
 void Model::delete_objects()
 {
     // Delete the components in reversed order.
+    delete timing;
     delete budget;
     delete dump;
     delete cross;
@@ -261,23 +266,36 @@ void Model::exec()
 
         // Calculate the advection tendency.
         boundary->set_ghost_cells_w(Boundary::Conservation_type);
+        timing->start("advec");
         advec->exec();
+        timing->stop("advec");
         boundary->set_ghost_cells_w(Boundary::Normal_type);
 
         // Calculate the diffusion tendency.
+        timing->start("diff");
         diff->exec();
+        timing->stop("diff");
 
         // Calculate the thermodynamics and the buoyancy tendency.
+        timing->start("thermo");
         thermo->exec();
+        timing->stop("thermo");
+
         // Calculate the tendency due to damping in the buffer layer.
+        timing->start("buffer");
         buffer->exec();
+        timing->stop("buffer");
 
         // Apply the large scale forcings. Keep this one always right before the pressure.
+        timing->start("force");
         force->exec(timeloop->get_sub_time_step());
+        timing->stop("force");
 
         // Solve the poisson equation for pressure.
         boundary->set_ghost_cells_w(Boundary::Conservation_type);
+        timing->start("pres");
         pres->exec(timeloop->get_sub_time_step());
+        timing->stop("pres");
         boundary->set_ghost_cells_w(Boundary::Normal_type);
 
         // Allow only for statistics when not in substep and not directly after restart.
@@ -295,9 +313,11 @@ void Model::exec()
             // Do the statistics.
             if (stats->doStats())
             {
+                timing->start("stats");
+
                 // Always process the default mask (the full field)
                 stats->get_mask(fields->atmp["tmp3"], fields->atmp["tmp4"], &stats->masks["default"]);
-                calc_stats("default");
+                stats->add_active_mask(&stats->masks["default"], fields->atmp["tmp3"], fields->atmp["tmp4"]);
 
                 // Work through the potential masks for the statistics.
                 for (std::vector<std::string>::const_iterator it=masklist.begin(); it!=masklist.end(); ++it)
@@ -305,37 +325,46 @@ void Model::exec()
                     if (*it == "wplus" || *it == "wmin")
                     {
                         fields->get_mask(fields->atmp["tmp3"], fields->atmp["tmp4"], &stats->masks[*it]);
-                        calc_stats(*it);
+                        stats->add_active_mask(&stats->masks[*it], fields->atmp["tmp3"], fields->atmp["tmp4"]);
                     }
                     else if (*it == "ql" || *it == "qlcore")
                     {
                         thermo->get_mask(fields->atmp["tmp3"], fields->atmp["tmp4"], &stats->masks[*it]);
-                        calc_stats(*it);
+                        stats->add_active_mask(&stats->masks[*it], fields->atmp["tmp3"], fields->atmp["tmp4"]);
                     }
                     else if (*it == "patch_high" || *it == "patch_low")
                     {
                         boundary->get_mask(fields->atmp["tmp3"], fields->atmp["tmp4"], &stats->masks[*it]);
-                        calc_stats(*it);
+                        stats->add_active_mask(&stats->masks[*it], fields->atmp["tmp3"], fields->atmp["tmp4"]);
                     }
                 }
 
+                // Calculate the statistics of all masks in a single sweep over the fields.
+                calc_stats();
+
                 // Store the stats data.
                 stats->exec(timeloop->get_iteration(), timeloop->get_time(), timeloop->get_itime());
+
+                timing->stop("stats");
             }
 
             // Save the selected cross sections to disk, cross sections are handled on CPU.
             if (cross->do_cross())
             {
+                timing->start("cross");
                 fields  ->exec_cross();
                 thermo  ->exec_cross();
                 boundary->exec_cross();
+                timing->stop("cross");
             }
 
             // Save the 3d dumps to disk
             if (dump->do_dump())
             {
+                timing->start("dump");
                 fields->exec_dump();
                 thermo->exec_dump();
+                timing->stop("dump");
             }
         }
 
@@ -347,7 +376,9 @@ void Model::exec()
         if (master->mode == "run")
         {
             // Integrate in time.
+            timing->start("timeloop");
             timeloop->exec();
+            timing->stop("timeloop");
 
             // Increase the time with the time step.
             timeloop->step_time();
@@ -361,8 +392,10 @@ void Model::exec()
                 #endif
 
                 // Save data to disk.
+                timing->start("save");
                 timeloop->save(timeloop->get_iotime());
                 fields  ->save(timeloop->get_iotime());
+                timing->stop("save");
             }
         }
 
@@ -377,8 +410,10 @@ void Model::exec()
                 break;
 
             // Load the data from disk.
+            timing->start("load");
             timeloop->load(timeloop->get_iotime());
             fields  ->load(timeloop->get_iotime());
+            timing->stop("load");
         }
 
         // Update the time dependent parameters.
@@ -386,19 +421,34 @@ void Model::exec()
         force   ->update_time_dependent();
 
         // Set the boundary conditions.
+        timing->start("boundary");
         boundary->exec();
+        timing->stop("boundary");
 
         // Calculate the field means, in case needed.
+        timing->start("fields");
         fields->exec();
+        timing->stop("fields");
 
-        // Get the viscosity to be used in diffusion.
+        // Get the viscosity to be used in diffusion, which is part of the cost of the diffusion.
+        timing->start("diff");
         diff->exec_viscosity();
+        timing->stop("diff");
 
         // Write status information to disk.
+        timing->start("status");
         print_status();
+        timing->stop("status");
+
+        // Write the timings of the modules to disk.
+        if (timeloop->do_check())
+            timing->exec(timeloop->get_iteration(), timeloop->get_time());
 
     } // End time loop.
 
+    // Print the time and volume of the communication per call site.
+    master->print_comm_profile();
+
     #ifdef USECUDA
     // At the end of the run, copy the data back from the GPU.
     fields  ->backward_device();
@@ -426,12 +476,19 @@ void Model::set_time_step()
 }
 
 // Calculate the statistics for all classes that have a statistics function.
-void Model::calc_stats(std::string maskname)
+void Model::calc_stats()
 {
-    fields  ->exec_stats(&stats->masks[maskname]);
-    thermo  ->exec_stats(&stats->masks[maskname]);
-    budget  ->exec_stats(&stats->masks[maskname]);
-    boundary->exec_stats(&stats->masks[maskname]);
+    // Sum the profiles of the masks over the processes in as few collectives as possible.
+    stats->start_reductions();
+
+    fields  ->exec_stats();
+    thermo  ->exec_stats();
+    boundary->exec_stats();
+
+    budget  ->exec_stats_masks();
+
+    stats->finish_reductions();
+    stats->clear_active_masks();
 }
 
 // Print the status information to the .out file.
@@ -42,6 +42,18 @@ Pres::Pres(Model* modelin, Input* input)
     fields = model->fields;
     master = model->master;
 
+    int nerror = 0;
+    nerror += input->get_item(&swlucache, "pres", "swlucache", "", "0");
+
+    if (nerror)
+        throw 1;
+
+    if (swlucache != "0" && swlucache != "1")
+    {
+        master->print_error("\"%s\" is an illegal value for swlucache\n", swlucache.c_str());
+        throw 1;
+    }
+
 #ifdef USECUDA
     iplanf = 0;
     jplanf = 0;
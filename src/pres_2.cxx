@@ -31,11 +31,24 @@
 #include "defines.h"
 #include "model.h"
 
+#ifdef USEOMP
+#include <omp.h>
+#endif
+
+namespace
+{
+    // Number of columns that the tridiagonal solver keeps in cache during both sweeps.
+    const int tdma_ncol = 64;
+}
+
 Pres_2::Pres_2(Model* modelin, Input* inputin) : Pres(modelin, inputin)
 {
     a = 0;
     c = 0;
     work2d = 0;
+    work_col = 0;
+    lu_bet = 0;
+    lu_gam = 0;
     bmati  = 0;
     bmatj  = 0;
 
@@ -53,6 +66,9 @@ Pres_2::~Pres_2()
     delete[] a;
     delete[] c;
     delete[] work2d;
+    delete[] work_col;
+    delete[] lu_bet;
+    delete[] lu_gam;
 
     delete[] bmati;
     delete[] bmatj;
@@ -73,7 +89,8 @@ void Pres_2::exec(double dt)
           dt);
 
     // solve the system
-    solve(fields->sd["p"]->data, fields->atmp["tmp1"]->data, fields->atmp["tmp2"]->data,
+    Tmp_fields tmp(fields);
+    solve(fields->sd["p"]->data, tmp.get_field()->data,
           grid->dz, fields->rhoref,
           grid->fftini, grid->fftouti, grid->fftinj, grid->fftoutj);
 
@@ -106,6 +123,17 @@ void Pres_2::init()
     c = new double[kmax];
 
     work2d = new double[imax*jmax];
+
+    // Each thread needs the diagonal of one block of columns and the ratios of all its levels.
+    work_col = new double[master->nthreads*tdma_ncol*(kmax+1)];
+
+    // the factorization of all systems is stored if requested
+    if (swlucache == "1")
+    {
+        const int ncells = grid->iblock*grid->jblock*kmax;
+        lu_bet = new double[ncells];
+        lu_gam = new double[ncells];
+    }
 }
 
 void Pres_2::set_values()
@@ -139,6 +167,58 @@ void Pres_2::set_values()
         a[k] = grid->dz[k+kgc] * fields->rhorefh[k+kgc  ]*grid->dzhi[k+kgc  ];
         c[k] = grid->dz[k+kgc] * fields->rhorefh[k+kgc+1]*grid->dzhi[k+kgc+1];
     }
+
+    if (swlucache == "1")
+        factorize(a, c, grid->dz, fields->rhoref);
+}
+
+// compute the diagonals of the LU factorization of the tridiagonal systems of all wave numbers,
+// this is the forward elimination of the tridiagonal solver without the right hand side
+void Pres_2::factorize(double* restrict a, double* restrict c,
+                       double* restrict dz, double* restrict rhoref)
+{
+    const int iblock = grid->iblock;
+    const int jblock = grid->jblock;
+    const int kmax   = grid->kmax;
+    const int kgc    = grid->kgc;
+
+    const int jj = iblock;
+    const int kk = iblock*jblock;
+
+    // swap the mpicoords, because domain is turned 90 degrees to avoid two mpi transposes
+    const int ioffset = master->mpicoordy * iblock;
+    const int joffset = master->mpicoordx * jblock;
+
+    for (int k=0; k<kmax; k++)
+    {
+        const double dzdzrho = dz[k+kgc]*dz[k+kgc] * rhoref[k+kgc];
+        for (int j=0; j<jblock; j++)
+        {
+            const int jindex = joffset + j;
+#pragma ivdep
+            for (int i=0; i<iblock; i++)
+            {
+                const int iindex = ioffset + i;
+                const int ijk    = i + j*jj + k*kk;
+
+                double b = dzdzrho*(bmati[iindex]+bmatj[jindex]) - (a[k]+c[k]);
+
+                // substitute BC's, see tdma
+                if (k == 0)
+                    b += a[0];
+                if (k == kmax-1)
+                    b += (iindex == 0 && jindex == 0) ? -c[kmax-1] : c[kmax-1];
+
+                if (k == 0)
+                    lu_bet[ijk] = b;
+                else
+                {
+                    lu_gam[ijk] = c[k-1] / lu_bet[ijk-kk];
+                    lu_bet[ijk] = b - a[k]*lu_gam[ijk];
+                }
+            }
+        }
+    }
 }
 
 void Pres_2::input(double* restrict p, 
@@ -167,6 +247,7 @@ void Pres_2::input(double* restrict p,
     grid->boundary_cyclic(vt, North_south_edge);
 
     // write pressure as a 3d array without ghost cells
+#pragma omp parallel for
     for (int k=0; k<grid->kmax; k++)
         for (int j=0; j<grid->jmax; j++)
 #pragma ivdep
@@ -181,70 +262,27 @@ void Pres_2::input(double* restrict p,
             }
 }
 
-void Pres_2::solve(double* restrict p, double* restrict work3d, double* restrict b,
+void Pres_2::solve(double* restrict p, double* restrict work3d,
                    double* restrict dz, double* restrict rhoref,
                    double* restrict fftini, double* restrict fftouti, 
                    double* restrict fftinj, double* restrict fftoutj)
 {
     const int imax   = grid->imax;
     const int jmax   = grid->jmax;
-    const int kmax   = grid->kmax;
-    const int iblock = grid->iblock;
-    const int jblock = grid->jblock;
     const int igc    = grid->igc;
     const int jgc    = grid->jgc;
     const int kgc    = grid->kgc;
 
-    int i,j,k,jj,kk,ijk;
-    int iindex,jindex;
+    int jj,kk,ijk;
 
     grid->fft_forward(p, work3d, fftini, fftouti, fftinj, fftoutj);
 
-    jj = iblock;
-    kk = iblock*jblock;
-
-    //for (int i=0; i<itot*jtot; ++i)
-    //  printf("%i %e\n",i,p[i]);
-    //exit(1);
-
-    // solve the tridiagonal system
-    // create vectors that go into the tridiagonal matrix solver
-    for (k=0; k<kmax; k++)
-        for (j=0; j<jblock; j++)
-#pragma ivdep
-            for (i=0; i<iblock; i++)
-            {
-                // swap the mpicoords, because domain is turned 90 degrees to avoid two mpi transposes
-                iindex = master->mpicoordy * iblock + i;
-                jindex = master->mpicoordx * jblock + j;
-
-                ijk  = i + j*jj + k*kk;
-                b[ijk] = dz[k+kgc]*dz[k+kgc] * rhoref[k+kgc]*(bmati[iindex]+bmatj[jindex]) - (a[k]+c[k]);
-                p[ijk] = dz[k+kgc]*dz[k+kgc] * p[ijk];
-            }
-
-    for (j=0; j<jblock; j++)
-#pragma ivdep
-        for (i=0; i<iblock; i++)
-        {
-            iindex = master->mpicoordy * iblock + i;
-            jindex = master->mpicoordx * jblock + j;
-
-            // substitute BC's
-            ijk = i + j*jj;
-            b[ijk] += a[0];
-
-            // for wave number 0, which contains average, set pressure at top to zero
-            ijk  = i + j*jj + (kmax-1)*kk;
-            if (iindex == 0 && jindex == 0)
-                b[ijk] -= c[kmax-1];
-            // set dp/dz at top to zero
-            else
-                b[ijk] += c[kmax-1];
-        }
-
-    // call tdma solver
-    tdma(a, b, c, p, work2d, work3d);
+    // solve the tridiagonal system, the diagonal is built inside the solver
+    // unless the factorization is stored
+    if (swlucache == "1")
+        tdma_lu(a, p, dz);
+    else
+        tdma(a, c, p, dz, rhoref);
 
     grid->fft_backward(p, work3d, fftini, fftouti, fftinj, fftoutj);
 
@@ -256,6 +294,7 @@ void Pres_2::solve(double* restrict p, double* restrict work3d, double* restrict
     kkp = grid->ijcells;
 
     // put the pressure back onto the original grid including ghost cells
+#pragma omp parallel for private(ijkp, ijk)
     for (int k=0; k<grid->kmax; k++)
         for (int j=0; j<grid->jmax; j++)
 #pragma ivdep
@@ -290,6 +329,7 @@ void Pres_2::output(double* restrict ut, double* restrict vt, double* restrict w
     const double dxi = 1./grid->dx;
     const double dyi = 1./grid->dy;
 
+#pragma omp parallel for
     for (int k=grid->kstart; k<grid->kend; k++)
         for (int j=grid->jstart; j<grid->jend; j++)
 #pragma ivdep
@@ -303,73 +343,135 @@ void Pres_2::output(double* restrict ut, double* restrict vt, double* restrict w
 }
 
 // tridiagonal matrix solver, taken from Numerical Recipes, Press
-void Pres_2::tdma(double* restrict a, double* restrict b, double* restrict c, 
-                  double* restrict p, double* restrict work2d, double* restrict work3d)
-
+// The columns are solved in blocks of tdma_ncol, such that the pressure and the ratios
+// of a block stay in cache between the forward and the backward sweep.
+void Pres_2::tdma(double* restrict a, double* restrict c, double* restrict p,
+                  double* restrict dz, double* restrict rhoref)
 {
-    int i,j,k,jj,kk,ijk,ij;
-    int iblock,jblock,kmax;
+    const int iblock = grid->iblock;
+    const int jblock = grid->jblock;
+    const int kmax   = grid->kmax;
+    const int kgc    = grid->kgc;
 
-    iblock = grid->iblock;
-    jblock = grid->jblock;
-    kmax = grid->kmax;
+    const int jj = iblock;
+    const int kk = iblock*jblock;
 
-    jj = iblock;
-    kk = iblock*jblock;
+    // swap the mpicoords, because domain is turned 90 degrees to avoid two mpi transposes
+    const int ioffset = master->mpicoordy * iblock;
+    const int joffset = master->mpicoordx * jblock;
 
-    for (j=0;j<jblock;j++)
-#pragma ivdep
-        for (i=0;i<iblock;i++)
-        {
-            ij = i + j*jj;
-            work2d[ij] = b[ij];
-        }
+#pragma omp parallel
+    {
+#ifdef USEOMP
+        const int thread = omp_get_thread_num();
+#else
+        const int thread = 0;
+#endif
+        double* restrict bet = &work_col[thread*tdma_ncol*(kmax+1)];
+        double* restrict gam = &bet[tdma_ncol];
 
-    for (j=0;j<jblock;j++)
-#pragma ivdep
-        for (i=0;i<iblock;i++)
+#pragma omp for schedule(static)
+        for (int j=0; j<jblock; j++)
         {
-            ij = i + j*jj;
-            p[ij] /= work2d[ij];
-        }
+            const int jindex = joffset + j;
 
-    for (k=1; k<kmax; k++)
-    {
-        for (j=0;j<jblock;j++)
-#pragma ivdep
-            for (i=0;i<iblock;i++)
+            for (int i0=0; i0<iblock; i0+=tdma_ncol)
             {
-                ij  = i + j*jj;
-                ijk = i + j*jj + k*kk;
-                work3d[ijk] = c[k-1] / work2d[ij];
-            }
-        for (j=0;j<jblock;j++)
+                const int ncol = std::min(tdma_ncol, iblock-i0);
+
+                // forward sweep, the diagonal b of the system is built per level,
+                // the right hand side is scaled with dz^2 on the fly
+                for (int k=0; k<kmax; k++)
+                {
+                    const double dzdz    = dz[k+kgc]*dz[k+kgc];
+                    const double dzdzrho = dzdz * rhoref[k+kgc];
 #pragma ivdep
-            for (i=0;i<iblock;i++)
-            {
-                ij  = i + j*jj;
-                ijk = i + j*jj + k*kk;
-                work2d[ij] = b[ijk] - a[k]*work3d[ijk];
-            }
-        for (j=0;j<jblock;j++)
+                    for (int n=0; n<ncol; n++)
+                    {
+                        const int iindex = ioffset + i0 + n;
+                        const int ijk    = i0+n + j*jj + k*kk;
+
+                        double b = dzdzrho*(bmati[iindex]+bmatj[jindex]) - (a[k]+c[k]);
+
+                        // substitute BC's
+                        if (k == 0)
+                            b += a[0];
+
+                        // for wave number 0, which contains average, set pressure at top to zero
+                        // and set dp/dz at top to zero for all others
+                        if (k == kmax-1)
+                            b += (iindex == 0 && jindex == 0) ? -c[kmax-1] : c[kmax-1];
+
+                        if (k == 0)
+                        {
+                            bet[n] = b;
+                            p[ijk] = dzdz * p[ijk];
+                        }
+                        else
+                        {
+                            gam[n + k*tdma_ncol] = c[k-1] / bet[n];
+                            bet[n] = b - a[k]*gam[n + k*tdma_ncol];
+                            p[ijk] = dzdz * p[ijk];
+                            p[ijk] -= a[k]*p[ijk-kk];
+                        }
+                        p[ijk] /= bet[n];
+                    }
+                }
+
+                // backward sweep
+                for (int k=kmax-2; k>=0; k--)
 #pragma ivdep
-            for (i=0;i<iblock;i++)
-            {
-                ij  = i + j*jj;
-                ijk = i + j*jj + k*kk;
-                p[ijk] -= a[k]*p[ijk-kk];
-                p[ijk] /= work2d[ij];
+                    for (int n=0; n<ncol; n++)
+                    {
+                        const int ijk = i0+n + j*jj + k*kk;
+                        p[ijk] -= gam[n + (k+1)*tdma_ncol]*p[ijk+kk];
+                    }
             }
+        }
     }
+}
 
-    for (k=kmax-2; k>=0; k--)
-        for (j=0;j<jblock;j++)
-#pragma ivdep
-            for (i=0;i<iblock;i++)
+// substitution step of the tridiagonal solver using the factorization stored by factorize
+void Pres_2::tdma_lu(double* restrict a, double* restrict p, double* restrict dz)
+{
+    const int iblock = grid->iblock;
+    const int jblock = grid->jblock;
+    const int kmax   = grid->kmax;
+    const int kgc    = grid->kgc;
+
+    const int jj = iblock;
+    const int kk = iblock*jblock;
+
+#pragma omp parallel for schedule(static)
+    for (int j=0; j<jblock; j++)
+        for (int i0=0; i0<iblock; i0+=tdma_ncol)
+        {
+            const int ncol = std::min(tdma_ncol, iblock-i0);
+
+            // forward sweep, the right hand side is scaled with dz^2 on the fly
+            for (int k=0; k<kmax; k++)
             {
-                ijk = i + j*jj + k*kk;
-                p[ijk] -= work3d[ijk+kk]*p[ijk+kk];
+                const double dzdz = dz[k+kgc]*dz[k+kgc];
+#pragma ivdep
+                for (int n=0; n<ncol; n++)
+                {
+                    const int ijk = i0+n + j*jj + k*kk;
+                    p[ijk] = dzdz * p[ijk];
+                    if (k > 0)
+                        p[ijk] -= a[k]*p[ijk-kk];
+                    p[ijk] /= lu_bet[ijk];
+                }
             }
+
+            // backward sweep
+            for (int k=kmax-2; k>=0; k--)
+#pragma ivdep
+                for (int n=0; n<ncol; n++)
+                {
+                    const int ijk = i0+n + j*jj + k*kk;
+                    p[ijk] -= lu_gam[ijk+kk]*p[ijk+kk];
+                }
+        }
 }
 
 #ifndef USECUDA
@@ -386,6 +488,7 @@ double Pres_2::calc_divergence(double* restrict u, double* restrict v, double* r
     double div    = 0.;
     double divmax = 0.;
 
+#pragma omp parallel for private(div) reduction(max:divmax)
     for (int k=grid->kstart; k<grid->kend; k++)
         for (int j=grid->jstart; j<grid->jend; j++)
 #pragma ivdep
@@ -37,6 +37,20 @@
 
 using namespace Finite_difference::O4;
 
+namespace
+{
+    /* Find the thickness of a vectorizable slice. There is a need for 8 slices for the pressure
+       solver and we use two three dimensional temp fields, so there are 4 slices per field.
+       The thickness is therefore jblock/4. Since there are always three ghost cells, even in a 2D
+       run the fields are large enough. */
+    // const int jslice = std::max(grid->jblock/4, 1);
+
+    /* The CPU version gives the best performance in case jslice = 1, due to cache misses.
+       In case this value will be set to larger than 1, checks need to be build in for out of bounds
+       reads in case jblock does not divide by 4. */
+    const int jslice = 1;
+}
+
 Pres_4::Pres_4(Model* modelin, Input* inputin) : Pres(modelin, inputin)
 {
     m1 = 0;
@@ -46,6 +60,7 @@ Pres_4::Pres_4(Model* modelin, Input* inputin) : Pres(modelin, inputin)
     m5 = 0;
     m6 = 0;
     m7 = 0;
+    lu_m = 0;
     bmati = 0;
     bmatj = 0;
 
@@ -75,6 +90,7 @@ Pres_4::~Pres_4()
     delete[] m5;
     delete[] m6;
     delete[] m7;
+    delete[] lu_m;
 
     delete[] bmati;
     delete[] bmatj;
@@ -100,29 +116,20 @@ void Pres_4::exec(double dt)
                     fields->ut->data, fields->vt->data, fields->wt->data, 
                     grid->dzi4, dt);
 
-    // 2. Solve the Poisson equation using FFTs and a heptadiagonal solver
-
-    /* Find the thickness of a vectorizable slice. There is a need for 8 slices for the pressure
-       solver and we use two three dimensional temp fields, so there are 4 slices per field.
-       The thickness is therefore jblock/4. Since there are always three ghost cells, even in a 2D
-       run the fields are large enough. */
-    // const int jslice = std::max(grid->jblock/4, 1);
-
-    /* The CPU version gives the best performance in case jslice = 1, due to cache misses.
-       In case this value will be set to larger than 1, checks need to be build in for out of bounds
-       reads in case jblock does not divide by 4. */
-    const int jslice = 1;
-
-    double *tmp2 = fields->atmp["tmp2"]->data;
-    double *tmp3 = fields->atmp["tmp3"]->data;
+    // 2. Solve the Poisson equation using FFTs and a heptadiagonal solver.
+    Tmp_fields tmp(fields);
+    double* work = tmp.get_field()->data;
 
     const int ns = grid->iblock*jslice*(grid->kmax+4);
+    double* s[8];
+    for (int n=0; n<8; ++n)
+        s[n] = tmp.get_slice(ns);
 
-    solve(fields->sd["p"]->data, fields->atmp["tmp1"]->data, grid->dz,
+    solve(fields->sd["p"]->data, work, grid->dz,
           m1, m2, m3, m4,
           m5, m6, m7,
-          &tmp2[0*ns], &tmp2[1*ns], &tmp2[2*ns], &tmp2[3*ns], 
-          &tmp3[0*ns], &tmp3[1*ns], &tmp3[2*ns], &tmp3[3*ns], 
+          s[0], s[1], s[2], s[3],
+          s[4], s[5], s[6], s[7],
           bmati, bmatj,
           jslice);
 
@@ -153,6 +160,10 @@ void Pres_4::init()
     m5 = new double[grid->kmax];
     m6 = new double[grid->kmax];
     m7 = new double[grid->kmax];
+
+    // Store the factorized matrices of all slices if requested.
+    if (swlucache == "1")
+        lu_m = new double[7*grid->iblock*grid->jblock*(grid->kmax+4)];
 }
 
 void Pres_4::set_values()
@@ -225,6 +236,22 @@ void Pres_4::set_values()
     m5[k] = (                  +  27.*dzhi4[kc] + 729.*dzhi4[kc+1] -  1.*dzhi4[kc] ) * dzi4[kc];
     m6[k] = (                                   -  27.*dzhi4[kc+1]                 ) * dzi4[kc];
     m7[k] = 0.;
+
+    // Factorize the matrices of all slices once, such that the solver only does the substitution.
+    if (swlucache == "1")
+    {
+        const int ns = grid->iblock*jslice*(kmax+4);
+        const int nm = 7*ns;
+
+        for (int n=0; n<grid->jblock/jslice; ++n)
+        {
+            double* m = &lu_m[n*nm];
+            build_matrix(m1, m2, m3, m4, m5, m6, m7,
+                         &m[0*ns], &m[1*ns], &m[2*ns], &m[3*ns], &m[4*ns], &m[5*ns], &m[6*ns],
+                         bmati, bmatj, n, jslice);
+            hdma_factor(&m[0*ns], &m[1*ns], &m[2*ns], &m[3*ns], &m[4*ns], &m[5*ns], &m[6*ns], jslice);
+        }
+    }
 }
 
 template<bool dim3>
@@ -274,6 +301,7 @@ void Pres_4::input(double* restrict p,
             wt[ijk+kk1] = -wt[ijk-kk1];
         }
 
+#pragma omp parallel for
     for (int k=0; k<grid->kmax; k++)
         for (int j=0; j<grid->jmax; j++)
 #pragma ivdep
@@ -308,16 +336,13 @@ void Pres_4::solve(double* restrict p, double* restrict work3d, double* restrict
     grid->fft_forward(p, work3d, grid->fftini, grid->fftouti, grid->fftinj, grid->fftoutj);
 
     int jj,kk,ik,ijk;
-    int iindex,jindex;
 
     jj = iblock;
     kk = iblock*jblock;
 
-    const int mpicoordx = master->mpicoordx;
-    const int mpicoordy = master->mpicoordy;
-
     // Calculate the step size.
     const int nj = jblock/jslice;
+    const int ns = iblock*jslice*(kmax+4);
 
     const int kki1 = 1*iblock*jslice;
     const int kki2 = 2*iblock*jslice;
@@ -325,98 +350,45 @@ void Pres_4::solve(double* restrict p, double* restrict work3d, double* restrict
 
     for (int n=0; n<nj; ++n)
     {
-        for (int j=0; j<jslice; ++j)
-#pragma ivdep
-            for (int i=0; i<iblock; ++i)
-            {
-                // Set a zero gradient bc at the bottom.
-                ik = i + j*jj;
-                m1temp[ik] =  0.;
-                m2temp[ik] =  0.;
-                m3temp[ik] =  0.;
-                m4temp[ik] =  1.;
-                m5temp[ik] =  0.;
-                m6temp[ik] =  0.;
-                m7temp[ik] = -1.;
-                ptemp [ik] =  0.;
-            }
+        // Use the stored factorization of this slice, or build and factorize the matrix.
+        if (swlucache == "1")
+        {
+            const int nm = 7*ns;
+            m1temp = &lu_m[n*nm + 0*ns];
+            m2temp = &lu_m[n*nm + 1*ns];
+            m3temp = &lu_m[n*nm + 2*ns];
+            m4temp = &lu_m[n*nm + 3*ns];
+            m5temp = &lu_m[n*nm + 4*ns];
+            m6temp = &lu_m[n*nm + 5*ns];
+            m7temp = &lu_m[n*nm + 6*ns];
+        }
+        else
+        {
+            build_matrix(m1, m2, m3, m4, m5, m6, m7,
+                         m1temp, m2temp, m3temp, m4temp, m5temp, m6temp, m7temp,
+                         bmati, bmatj, n, jslice);
+            hdma_factor(m1temp, m2temp, m3temp, m4temp, m5temp, m6temp, m7temp, jslice);
+        }
 
         for (int j=0; j<jslice; ++j)
 #pragma ivdep
             for (int i=0; i<iblock; ++i)
             {
+                // Set a zero gradient bc at the bottom.
                 ik = i + j*jj;
-                m1temp[ik+kki1] =  0.;
-                m2temp[ik+kki1] =  0.;
-                m3temp[ik+kki1] =  0.;
-                m4temp[ik+kki1] =  1.;
-                m5temp[ik+kki1] = -1.;
-                m6temp[ik+kki1] =  0.;
-                m7temp[ik+kki1] =  0.;
-                ptemp [ik+kki1] =  0.;
+                ptemp[ik     ] = 0.;
+                ptemp[ik+kki1] = 0.;
             }
 
         for (int k=0; k<kmax; ++k)
             for (int j=0; j<jslice; ++j)
-            {
-                jindex = mpicoordx*jblock + n*jslice + j;
 #pragma ivdep
                 for (int i=0; i<iblock; ++i)
                 {
-                    // Swap the mpicoords, because domain is turned 90 degrees to avoid two mpi transposes.
-                    iindex = mpicoordy*iblock + i;
-
                     ijk = i + (j + n*jslice)*jj + k*kk;
                     ik  = i + j*jj + k*kki1;
-                    m1temp[ik+kki2] = m1[k];
-                    m2temp[ik+kki2] = m2[k];
-                    m3temp[ik+kki2] = m3[k];
-                    m4temp[ik+kki2] = m4[k] + bmati[iindex] + bmatj[jindex];
-                    m5temp[ik+kki2] = m5[k];
-                    m6temp[ik+kki2] = m6[k];
-                    m7temp[ik+kki2] = m7[k];
-                    ptemp [ik+kki2] = p[ijk];
-                }
-            }
-
-        for (int j=0; j<jslice; ++j)
-        {
-            jindex = mpicoordx*jblock + n*jslice + j;
-#pragma ivdep
-            for (int i=0; i<iblock; ++i)
-            {
-                // Swap the mpicoords, because domain is turned 90 degrees to avoid two mpi transposes.
-                iindex = mpicoordy*iblock + i;
-
-                // Set the top boundary.
-                ik = i + j*jj + kmax*kki1;
-                if (iindex == 0 && jindex == 0)
-                {
-                    m1temp[ik+kki2] =    0.;
-                    m2temp[ik+kki2] = -1/3.;
-                    m3temp[ik+kki2] =    2.;
-                    m4temp[ik+kki2] =    1.;
-
-                    m1temp[ik+kki3] =   -2.;
-                    m2temp[ik+kki3] =    9.;
-                    m3temp[ik+kki3] =    0.;
-                    m4temp[ik+kki3] =    1.;
-                }
-                // Set dp/dz at top to zero.
-                else
-                {
-                    m1temp[ik+kki2] =  0.;
-                    m2temp[ik+kki2] =  0.;
-                    m3temp[ik+kki2] = -1.;
-                    m4temp[ik+kki2] =  1.;
-
-                    m1temp[ik+kki3] = -1.;
-                    m2temp[ik+kki3] =  0.;
-                    m3temp[ik+kki3] =  0.;
-                    m4temp[ik+kki3] =  1.;
+                    ptemp[ik+kki2] = p[ijk];
                 }
-            }
-        }
 
         for (int j=0; j<jslice; ++j)
 #pragma ivdep
@@ -424,20 +396,14 @@ void Pres_4::solve(double* restrict p, double* restrict work3d, double* restrict
             {
                 // Set the top boundary.
                 ik = i + j*jj + kmax*kki1;
-                m5temp[ik+kki2] = 0.;
-                m6temp[ik+kki2] = 0.;
-                m7temp[ik+kki2] = 0.;
-                ptemp [ik+kki2] = 0.;
-
-                m5temp[ik+kki3] = 0.;
-                m6temp[ik+kki3] = 0.;
-                m7temp[ik+kki3] = 0.;
-                ptemp [ik+kki3] = 0.;
+                ptemp[ik+kki2] = 0.;
+                ptemp[ik+kki3] = 0.;
             }
 
-        hdma(m1temp, m2temp, m3temp, m4temp, m5temp, m6temp, m7temp, ptemp, jslice);
+        hdma_solve(m1temp, m2temp, m3temp, m4temp, m5temp, m6temp, m7temp, ptemp, jslice);
 
         // Put back the solution.
+#pragma omp parallel for
         for (int k=0; k<kmax; ++k)
             for (int j=0; j<jslice; ++j)
 #pragma ivdep
@@ -460,6 +426,7 @@ void Pres_4::solve(double* restrict p, double* restrict work3d, double* restrict
     kkp1 = 1*grid->ijcells;
     kkp2 = 2*grid->ijcells;
 
+#pragma omp parallel for private(ijkp, ijk)
     for (int k=0; k<grid->kmax; k++)
         for (int j=0; j<grid->jmax; j++)
 #pragma ivdep
@@ -494,6 +461,134 @@ void Pres_4::solve(double* restrict p, double* restrict work3d, double* restrict
     grid->boundary_cyclic(p);
 }
 
+// Fill the heptadiagonal matrices of slice n, including the boundary conditions.
+void Pres_4::build_matrix(double* restrict m1, double* restrict m2, double* restrict m3, double* restrict m4,
+                          double* restrict m5, double* restrict m6, double* restrict m7,
+                          double* restrict m1temp, double* restrict m2temp, double* restrict m3temp, double* restrict m4temp,
+                          double* restrict m5temp, double* restrict m6temp, double* restrict m7temp,
+                          double* restrict bmati, double* restrict bmatj,
+                          const int n, const int jslice)
+{
+    const int kmax   = grid->kmax;
+    const int iblock = grid->iblock;
+    const int jblock = grid->jblock;
+
+    const int jj = iblock;
+
+    const int mpicoordx = master->mpicoordx;
+    const int mpicoordy = master->mpicoordy;
+
+    const int kki1 = 1*iblock*jslice;
+    const int kki2 = 2*iblock*jslice;
+    const int kki3 = 3*iblock*jslice;
+
+    int ik,iindex,jindex;
+
+    for (int j=0; j<jslice; ++j)
+#pragma ivdep
+        for (int i=0; i<iblock; ++i)
+        {
+            // Set a zero gradient bc at the bottom.
+            ik = i + j*jj;
+            m1temp[ik] =  0.;
+            m2temp[ik] =  0.;
+            m3temp[ik] =  0.;
+            m4temp[ik] =  1.;
+            m5temp[ik] =  0.;
+            m6temp[ik] =  0.;
+            m7temp[ik] = -1.;
+        }
+
+    for (int j=0; j<jslice; ++j)
+#pragma ivdep
+        for (int i=0; i<iblock; ++i)
+        {
+            ik = i + j*jj;
+            m1temp[ik+kki1] =  0.;
+            m2temp[ik+kki1] =  0.;
+            m3temp[ik+kki1] =  0.;
+            m4temp[ik+kki1] =  1.;
+            m5temp[ik+kki1] = -1.;
+            m6temp[ik+kki1] =  0.;
+            m7temp[ik+kki1] =  0.;
+        }
+
+    for (int k=0; k<kmax; ++k)
+        for (int j=0; j<jslice; ++j)
+        {
+            jindex = mpicoordx*jblock + n*jslice + j;
+#pragma ivdep
+            for (int i=0; i<iblock; ++i)
+            {
+                // Swap the mpicoords, because domain is turned 90 degrees to avoid two mpi transposes.
+                iindex = mpicoordy*iblock + i;
+
+                ik  = i + j*jj + k*kki1;
+                m1temp[ik+kki2] = m1[k];
+                m2temp[ik+kki2] = m2[k];
+                m3temp[ik+kki2] = m3[k];
+                m4temp[ik+kki2] = m4[k] + bmati[iindex] + bmatj[jindex];
+                m5temp[ik+kki2] = m5[k];
+                m6temp[ik+kki2] = m6[k];
+                m7temp[ik+kki2] = m7[k];
+            }
+        }
+
+    for (int j=0; j<jslice; ++j)
+    {
+        jindex = mpicoordx*jblock + n*jslice + j;
+#pragma ivdep
+        for (int i=0; i<iblock; ++i)
+        {
+            // Swap the mpicoords, because domain is turned 90 degrees to avoid two mpi transposes.
+            iindex = mpicoordy*iblock + i;
+
+            // Set the top boundary.
+            ik = i + j*jj + kmax*kki1;
+            if (iindex == 0 && jindex == 0)
+            {
+                m1temp[ik+kki2] =    0.;
+                m2temp[ik+kki2] = -1/3.;
+                m3temp[ik+kki2] =    2.;
+                m4temp[ik+kki2] =    1.;
+
+                m1temp[ik+kki3] =   -2.;
+                m2temp[ik+kki3] =    9.;
+                m3temp[ik+kki3] =    0.;
+                m4temp[ik+kki3] =    1.;
+            }
+            // Set dp/dz at top to zero.
+            else
+            {
+                m1temp[ik+kki2] =  0.;
+                m2temp[ik+kki2] =  0.;
+                m3temp[ik+kki2] = -1.;
+                m4temp[ik+kki2] =  1.;
+
+                m1temp[ik+kki3] = -1.;
+                m2temp[ik+kki3] =  0.;
+                m3temp[ik+kki3] =  0.;
+                m4temp[ik+kki3] =  1.;
+            }
+        }
+    }
+
+    for (int j=0; j<jslice; ++j)
+#pragma ivdep
+        for (int i=0; i<iblock; ++i)
+        {
+            // Set the top boundary.
+            ik = i + j*jj + kmax*kki1;
+            m5temp[ik+kki2] = 0.;
+            m6temp[ik+kki2] = 0.;
+            m7temp[ik+kki2] = 0.;
+
+            m5temp[ik+kki3] = 0.;
+            m6temp[ik+kki3] = 0.;
+            m7temp[ik+kki3] = 0.;
+        }
+}
+
 template<bool dim3>
 void Pres_4::output(double* restrict ut, double* restrict vt, double* restrict wt, 
                     double* restrict p , double* restrict dzhi4)
@@ -520,6 +615,7 @@ void Pres_4::output(double* restrict ut, double* restrict vt, double* restrict w
                 vt[ijk] -= (cg0*p[ijk-jj2] + cg1*p[ijk-jj1] + cg2*p[ijk] + cg3*p[ijk+jj1]) * cgi*dyi;
         }
 
+#pragma omp parallel for
     for (int k=grid->kstart+1; k<grid->kend; k++)
         for (int j=grid->jstart; j<grid->jend; j++)
 #pragma ivdep
@@ -533,9 +629,9 @@ void Pres_4::output(double* restrict ut, double* restrict vt, double* restrict w
             }
 }
 
-void Pres_4::hdma(double* restrict m1, double* restrict m2, double* restrict m3, double* restrict m4,
-                  double* restrict m5, double* restrict m6, double* restrict m7, double* restrict p,
-                  const int jslice)
+void Pres_4::hdma_factor(double* restrict m1, double* restrict m2, double* restrict m3, double* restrict m4,
+                         double* restrict m5, double* restrict m6, double* restrict m7,
+                         const int jslice)
 {
     const int kmax   = grid->kmax;
     const int iblock = grid->iblock;
@@ -548,52 +644,85 @@ void Pres_4::hdma(double* restrict m1, double* restrict m2, double* restrict m3,
 
     int k,ik;
 
-    // Use LU factorization.
-    k = 0;
-    for (int j=0; j<jslice; ++j)
+    // The columns are independent. All i-loops have the same bounds and a static schedule,
+    // such that each thread solves the same columns in every sweep and no barriers are needed.
+#pragma omp parallel private(k, ik)
+    {
+        // Use LU factorization.
+        k = 0;
+        for (int j=0; j<jslice; ++j)
+#pragma omp for schedule(static) nowait
 #pragma ivdep
-        for (int i=0; i<iblock; ++i)
-        {
-            ik = i + j*jj;
-            m1[ik] = 1.;
-            m2[ik] = 1.;
-            m3[ik] = 1.            / m4[ik];
-            m4[ik] = 1.;
-            m5[ik] = m5[ik]*m3[ik];
-            m6[ik] = m6[ik]*m3[ik];
-            m7[ik] = m7[ik]*m3[ik];
-        }
+            for (int i=0; i<iblock; ++i)
+            {
+                ik = i + j*jj;
+                m1[ik] = 1.;
+                m2[ik] = 1.;
+                m3[ik] = 1.            / m4[ik];
+                m4[ik] = 1.;
+                m5[ik] = m5[ik]*m3[ik];
+                m6[ik] = m6[ik]*m3[ik];
+                m7[ik] = m7[ik]*m3[ik];
+            }
 
-    k = 1;
-    for (int j=0; j<jslice; ++j)
+        k = 1;
+        for (int j=0; j<jslice; ++j)
+#pragma omp for schedule(static) nowait
 #pragma ivdep
-        for (int i=0; i<iblock; ++i)
-        {
-            ik = i + j*jj + k*kk1;
-            m1[ik] = 1.;
-            m2[ik] = 1.;
-            m3[ik] = m3[ik]                     / m4[ik-kk1];
-            m4[ik] = m4[ik] - m3[ik]*m5[ik-kk1];
-            m5[ik] = m5[ik] - m3[ik]*m6[ik-kk1];
-            m6[ik] = m6[ik] - m3[ik]*m7[ik-kk1];
-        }
+            for (int i=0; i<iblock; ++i)
+            {
+                ik = i + j*jj + k*kk1;
+                m1[ik] = 1.;
+                m2[ik] = 1.;
+                m3[ik] = m3[ik]                     / m4[ik-kk1];
+                m4[ik] = m4[ik] - m3[ik]*m5[ik-kk1];
+                m5[ik] = m5[ik] - m3[ik]*m6[ik-kk1];
+                m6[ik] = m6[ik] - m3[ik]*m7[ik-kk1];
+            }
 
-    k = 2;
-    for (int j=0; j<jslice; ++j)
+        k = 2;
+        for (int j=0; j<jslice; ++j)
+#pragma omp for schedule(static) nowait
 #pragma ivdep
-        for (int i=0; i<iblock; ++i)
-        {
-            ik = i + j*jj + k*kk1;
-            m1[ik] = 1.;
-            m2[ik] =   m2[ik]                                           / m4[ik-kk2];
-            m3[ik] = ( m3[ik]                     - m2[ik]*m5[ik-kk2] ) / m4[ik-kk1];
-            m4[ik] =   m4[ik] - m3[ik]*m5[ik-kk1] - m2[ik]*m6[ik-kk2];
-            m5[ik] =   m5[ik] - m3[ik]*m6[ik-kk1] - m2[ik]*m7[ik-kk2];
-            m6[ik] =   m6[ik] - m3[ik]*m7[ik-kk1];
-        }
+            for (int i=0; i<iblock; ++i)
+            {
+                ik = i + j*jj + k*kk1;
+                m1[ik] = 1.;
+                m2[ik] =   m2[ik]                                           / m4[ik-kk2];
+                m3[ik] = ( m3[ik]                     - m2[ik]*m5[ik-kk2] ) / m4[ik-kk1];
+                m4[ik] =   m4[ik] - m3[ik]*m5[ik-kk1] - m2[ik]*m6[ik-kk2];
+                m5[ik] =   m5[ik] - m3[ik]*m6[ik-kk1] - m2[ik]*m7[ik-kk2];
+                m6[ik] =   m6[ik] - m3[ik]*m7[ik-kk1];
+            }
 
-    for (k=3; k<kmax+2; ++k)
+        for (k=3; k<kmax+2; ++k)
+            for (int j=0; j<jslice; ++j)
+#pragma omp for schedule(static) nowait
+#pragma ivdep
+                for (int i=0; i<iblock; ++i)
+                {
+                    ik = i + j*jj + k*kk1;
+                    m1[ik] = ( m1[ik]                                                            ) / m4[ik-kk3];
+                    m2[ik] = ( m2[ik]                                         - m1[ik]*m5[ik-kk3]) / m4[ik-kk2];
+                    m3[ik] = ( m3[ik]                     - m2[ik]*m5[ik-kk2] - m1[ik]*m6[ik-kk3]) / m4[ik-kk1];
+                    m4[ik] =   m4[ik] - m3[ik]*m5[ik-kk1] - m2[ik]*m6[ik-kk2] - m1[ik]*m7[ik-kk3];
+                    m5[ik] =   m5[ik] - m3[ik]*m6[ik-kk1] - m2[ik]*m7[ik-kk2];
+                    m6[ik] =   m6[ik] - m3[ik]*m7[ik-kk1];
+                }
+
+        k = kmax+1;
+        for (int j=0; j<jslice; ++j)
+#pragma omp for schedule(static) nowait
+#pragma ivdep
+            for (int i=0; i<iblock; ++i)
+            {
+                ik = i + j*jj + k*kk1;
+                m7[ik] = 1.;
+            }
+
+        k = kmax+2;
         for (int j=0; j<jslice; ++j)
+#pragma omp for schedule(static) nowait
 #pragma ivdep
             for (int i=0; i<iblock; ++i)
             {
@@ -603,89 +732,93 @@ void Pres_4::hdma(double* restrict m1, double* restrict m2, double* restrict m3,
                 m3[ik] = ( m3[ik]                     - m2[ik]*m5[ik-kk2] - m1[ik]*m6[ik-kk3]) / m4[ik-kk1];
                 m4[ik] =   m4[ik] - m3[ik]*m5[ik-kk1] - m2[ik]*m6[ik-kk2] - m1[ik]*m7[ik-kk3];
                 m5[ik] =   m5[ik] - m3[ik]*m6[ik-kk1] - m2[ik]*m7[ik-kk2];
-                m6[ik] =   m6[ik] - m3[ik]*m7[ik-kk1];
+                m6[ik] = 1.;
+                m7[ik] = 1.;
             }
 
-    k = kmax+1;
-    for (int j=0; j<jslice; ++j)
+        k = kmax+3;
+        for (int j=0; j<jslice; ++j)
+#pragma omp for schedule(static) nowait
 #pragma ivdep
-        for (int i=0; i<iblock; ++i)
-        {
-            ik = i + j*jj + k*kk1;
-            m7[ik] = 1.;
-        }
+            for (int i=0; i<iblock; ++i)
+            {
+                ik = i + j*jj + k*kk1;
+                m1[ik] = ( m1[ik]                                                            ) / m4[ik-kk3];
+                m2[ik] = ( m2[ik]                                         - m1[ik]*m5[ik-kk3]) / m4[ik-kk2];
+                m3[ik] = ( m3[ik]                     - m2[ik]*m5[ik-kk2] - m1[ik]*m6[ik-kk3]) / m4[ik-kk1];
+                m4[ik] =   m4[ik] - m3[ik]*m5[ik-kk1] - m2[ik]*m6[ik-kk2] - m1[ik]*m7[ik-kk3];
+                m5[ik] = 1.;
+                m6[ik] = 1.;
+                m7[ik] = 1.;
+            }
+    }
+}
 
-    k = kmax+2;
-    for (int j=0; j<jslice; ++j)
-#pragma ivdep
-        for (int i=0; i<iblock; ++i)
-        {
-            ik = i + j*jj + k*kk1;
-            m1[ik] = ( m1[ik]                                                            ) / m4[ik-kk3];
-            m2[ik] = ( m2[ik]                                         - m1[ik]*m5[ik-kk3]) / m4[ik-kk2];
-            m3[ik] = ( m3[ik]                     - m2[ik]*m5[ik-kk2] - m1[ik]*m6[ik-kk3]) / m4[ik-kk1];
-            m4[ik] =   m4[ik] - m3[ik]*m5[ik-kk1] - m2[ik]*m6[ik-kk2] - m1[ik]*m7[ik-kk3];
-            m5[ik] =   m5[ik] - m3[ik]*m6[ik-kk1] - m2[ik]*m7[ik-kk2];
-            m6[ik] = 1.;
-            m7[ik] = 1.;
-        }
+void Pres_4::hdma_solve(double* restrict m1, double* restrict m2, double* restrict m3, double* restrict m4,
+                        double* restrict m5, double* restrict m6, double* restrict m7, double* restrict p,
+                        const int jslice)
+{
+    const int kmax   = grid->kmax;
+    const int iblock = grid->iblock;
 
-    k = kmax+3;
-    for (int j=0; j<jslice; ++j)
-#pragma ivdep
-        for (int i=0; i<iblock; ++i)
-        {
-            ik = i + j*jj + k*kk1;
-            m1[ik] = ( m1[ik]                                                            ) / m4[ik-kk3];
-            m2[ik] = ( m2[ik]                                         - m1[ik]*m5[ik-kk3]) / m4[ik-kk2];
-            m3[ik] = ( m3[ik]                     - m2[ik]*m5[ik-kk2] - m1[ik]*m6[ik-kk3]) / m4[ik-kk1];
-            m4[ik] =   m4[ik] - m3[ik]*m5[ik-kk1] - m2[ik]*m6[ik-kk2] - m1[ik]*m7[ik-kk3];
-            m5[ik] = 1.;
-            m6[ik] = 1.;
-            m7[ik] = 1.;
-        }
+    const int jj = grid->iblock;
 
-    // Do the backward substitution.
-    // First, solve Ly = p, forward.
-    for (int j=0; j<jslice; ++j)
-#pragma ivdep
-        for (int i=0; i<iblock; ++i)
-        {
-            ik = i + j*jj;
-            p[ik    ] =             p[ik    ]*m3[ik    ];
-            p[ik+kk1] = p[ik+kk1] - p[ik    ]*m3[ik+kk1];
-            p[ik+kk2] = p[ik+kk2] - p[ik+kk1]*m3[ik+kk2] - p[ik]*m2[ik+kk2];
-        }
+    const int kk1 = 1*grid->iblock*jslice;
+    const int kk2 = 2*grid->iblock*jslice;
+    const int kk3 = 3*grid->iblock*jslice;
+
+    int k,ik;
 
-    for (k=3; k<kmax+4; ++k)
+    // The columns are independent. All i-loops have the same bounds and a static schedule,
+    // such that each thread solves the same columns in every sweep and no barriers are needed.
+#pragma omp parallel private(k, ik)
+    {
+        // Do the backward substitution.
+        // First, solve Ly = p, forward.
         for (int j=0; j<jslice; ++j)
+#pragma omp for schedule(static) nowait
 #pragma ivdep
             for (int i=0; i<iblock; ++i)
             {
-                ik = i + j*jj + k*kk1;
-                p[ik] = p[ik] - p[ik-kk1]*m3[ik] - p[ik-kk2]*m2[ik] - p[ik-kk3]*m1[ik];
+                ik = i + j*jj;
+                p[ik    ] =             p[ik    ]*m3[ik    ];
+                p[ik+kk1] = p[ik+kk1] - p[ik    ]*m3[ik+kk1];
+                p[ik+kk2] = p[ik+kk2] - p[ik+kk1]*m3[ik+kk2] - p[ik]*m2[ik+kk2];
             }
 
-    // Second, solve Ux=y, backward.
-    k = kmax+3;
-    for (int j=0; j<jslice; ++j)
+        for (k=3; k<kmax+4; ++k)
+            for (int j=0; j<jslice; ++j)
+#pragma omp for schedule(static) nowait
 #pragma ivdep
-        for (int i=0; i<iblock; ++i)
-        {
-            ik = i + j*jj + k*kk1;
-            p[ik    ] =   p[ik    ]                                             / m4[ik    ];
-            p[ik-kk1] = ( p[ik-kk1] - p[ik    ]*m5[ik-kk1] )                    / m4[ik-kk1];
-            p[ik-kk2] = ( p[ik-kk2] - p[ik-kk1]*m5[ik-kk2] - p[ik]*m6[ik-kk2] ) / m4[ik-kk2];
-        }
+                for (int i=0; i<iblock; ++i)
+                {
+                    ik = i + j*jj + k*kk1;
+                    p[ik] = p[ik] - p[ik-kk1]*m3[ik] - p[ik-kk2]*m2[ik] - p[ik-kk3]*m1[ik];
+                }
 
-    for (k=kmax; k>=0; --k)
+        // Second, solve Ux=y, backward.
+        k = kmax+3;
         for (int j=0; j<jslice; ++j)
+#pragma omp for schedule(static) nowait
 #pragma ivdep
             for (int i=0; i<iblock; ++i)
             {
                 ik = i + j*jj + k*kk1;
-                p[ik] = ( p[ik] - p[ik+kk1]*m5[ik] - p[ik+kk2]*m6[ik] - p[ik+kk3]*m7[ik] ) / m4[ik];
+                p[ik    ] =   p[ik    ]                                             / m4[ik    ];
+                p[ik-kk1] = ( p[ik-kk1] - p[ik    ]*m5[ik-kk1] )                    / m4[ik-kk1];
+                p[ik-kk2] = ( p[ik-kk2] - p[ik-kk1]*m5[ik-kk2] - p[ik]*m6[ik-kk2] ) / m4[ik-kk2];
             }
+
+        for (k=kmax; k>=0; --k)
+            for (int j=0; j<jslice; ++j)
+#pragma omp for schedule(static) nowait
+#pragma ivdep
+                for (int i=0; i<iblock; ++i)
+                {
+                    ik = i + j*jj + k*kk1;
+                    p[ik] = ( p[ik] - p[ik+kk1]*m5[ik] - p[ik+kk2]*m6[ik] - p[ik+kk3]*m7[ik] ) / m4[ik];
+                }
+    }
 }
 
 double Pres_4::calc_divergence(double* restrict u, double* restrict v, double* restrict w, double* restrict dzi4)
@@ -703,6 +836,7 @@ double Pres_4::calc_divergence(double* restrict u, double* restrict v, double* r
     double div, divmax;
     divmax = 0;
 
+#pragma omp parallel for private(div) reduction(max:divmax)
     for (int k=grid->kstart; k<grid->kend; k++)
         for (int j=grid->jstart; j<grid->jend; j++)
 #pragma ivdep
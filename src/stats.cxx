@@ -25,6 +25,8 @@
 #include <sstream>
 #include <iostream>
 #include <iomanip>
+#include <exception>
+#include <utility>
 #include "master.h"
 #include "grid.h"
 #include "fields.h"
@@ -42,6 +44,28 @@
 using namespace netCDF;
 using namespace netCDF::exceptions;
 
+namespace
+{
+    // Offset of the neighbouring cell with which the masks are interpolated horizontally.
+    inline int get_mask_shift(const int loc[3], const int jj)
+    {
+        return loc[0] == 1 ? -1 : loc[1] == 1 ? -jj : 0;
+    }
+
+    // Add a value to the sums of the masks that contain the cell, with half the weight
+    // for the masks that contain only one of the two cells of the interpolation.
+    inline void add_to_masks(double* const restrict sum, const double value, unsigned int full, unsigned int half)
+    {
+        for (int n=0; full | half; ++n, full >>= 1, half >>= 1)
+        {
+            if (full & 1)
+                sum[n] += value;
+            else if (half & 1)
+                sum[n] += 0.5*value;
+        }
+    }
+}
+
 Stats::Stats(Model* modelin, Input* inputin)
 {
     model = modelin;
@@ -51,11 +75,39 @@ Stats::Stats(Model* modelin, Input* inputin)
     nmask  = 0;
     nmaskh = 0;
 
+    batch_reductions = false;
+
+    writer_stop  = false;
+    writer_error = false;
+
     int nerror = 0;
     nerror += inputin->get_item(&swstats, "stats", "swstats", "", "0");
 
     if (swstats == "1")
+    {
         nerror += inputin->get_item(&sampletime, "stats", "sampletime", "");
+        nerror += inputin->get_item(&swasync, "stats", "swasync", "", "1");
+        nerror += inputin->get_item(&nqueue, "stats", "nqueue", "", 4);
+        nerror += inputin->get_item(&syncsamples, "stats", "syncsamples", "", 1);
+
+        if (!(swasync == "0" || swasync == "1"))
+        {
+            ++nerror;
+            master->print_error("\"%s\" is an illegal value for swasync\n", swasync.c_str());
+        }
+
+        if (nqueue < 1)
+        {
+            ++nerror;
+            master->print_error("nqueue = %d has to be at least 1\n", nqueue);
+        }
+
+        if (syncsamples < 0)
+        {
+            ++nerror;
+            master->print_error("syncsamples = %d cannot be negative\n", syncsamples);
+        }
+    }
 
     if (!(swstats == "0" || swstats == "1"))
     {
@@ -69,6 +121,9 @@ Stats::Stats(Model* modelin, Input* inputin)
 
 Stats::~Stats()
 {
+    // write the samples that are still queued before the files are closed
+    stop_writer();
+
     delete[] nmask;
     delete[] nmaskh;
 
@@ -213,40 +268,175 @@ void Stats::exec(int iteration, double time, unsigned long itime)
     // write message in case stats is triggered
     master->print_message("Saving stats for time %f\n", model->timeloop->get_time());
 
-    for (Mask_map::iterator it=masks.begin(); it!=masks.end(); ++it)
+    int nerror = 0;
+
+    if (master->mpiid == 0)
     {
-        // shortcut
-        Mask* m = &it->second;
+        // copy the profiles and time series, such that the model can continue while they are written
+        Stats_sample sample;
+        sample.iteration = iteration;
+        sample.time      = time;
+        sample.index     = nstats;
+        sample.sync      = (syncsamples > 0) && ((nstats+1) % syncsamples == 0);
+
+        for (Mask_map::const_iterator it=masks.begin(); it!=masks.end(); ++it)
+        {
+            for (Prof_map::const_iterator it2=it->second.profs.begin(); it2!=it->second.profs.end(); ++it2)
+                sample.data.insert(sample.data.end(), it2->second.data, it2->second.data+grid->kcells);
 
-        // put the data into the NetCDF file
-        if (master->mpiid == 0)
+            for (Time_series_map::const_iterator it2=it->second.tseries.begin(); it2!=it->second.tseries.end(); ++it2)
+                sample.data.push_back(it2->second.data);
+        }
+
+        if (swasync == "1")
         {
-            const std::vector<size_t> time_index = {static_cast<size_t>(nstats)};
+            if (!writer.joinable())
+            {
+                writer_stop  = false;
+                writer_error = false;
+                writer = std::thread(&Stats::run_writer, this);
+            }
 
-            m->t_var   .putVar(time_index, &time     );
-            m->iter_var.putVar(time_index, &iteration);
+            std::unique_lock<std::mutex> lock(writer_mutex);
 
-            const std::vector<size_t> time_height_index = {static_cast<size_t>(nstats), 0};
-            std::vector<size_t> time_height_size  = {1, 0};
+            // wait for the writer if the queue is full
+            while (writer_queue.size() >= (size_t)nqueue && !writer_error)
+                writer_cond.wait(lock);
 
-            for (Prof_map::const_iterator it=m->profs.begin(); it!=m->profs.end(); ++it)
+            if (writer_error)
             {
-                time_height_size[1] = m->profs[it->first].ncvar.getDim(1).getSize();
-                m->profs[it->first].ncvar.putVar(time_height_index, time_height_size, &m->profs[it->first].data[grid->kstart]);
+                master->print_error("Writing the statistics failed: %s\n", writer_message.c_str());
+                writer_error = false; // reported, not again at the end
+                ++nerror;
+            }
+            else
+            {
+                writer_queue.push_back(std::move(sample));
+                writer_cond.notify_all();
             }
+        }
+        else
+            write_sample(sample);
+    }
 
-            for (Time_series_map::const_iterator it=m->tseries.begin(); it!=m->tseries.end(); ++it)
-                m->tseries[it->first].ncvar.putVar(time_index, &m->tseries[it->first].data);
+    // Crash on all processes in case the statistics could not be written
+    if (swasync == "1")
+    {
+        master->broadcast(&nerror, 1);
+        if (nerror)
+            throw 1;
+    }
 
-            // Synchronize the NetCDF file
-            // BvS: only the last netCDF4-c++ includes the NcFile->sync()
-            //      for now use sync() from the netCDF-C library to support older NetCDF4-c++ versions
-            //m->dataFile->sync();
+    ++nstats;
+}
+
+/**
+ * This function writes a sample of the statistics of all masks to the NetCDF files.
+ */
+void Stats::write_sample(const Stats_sample& sample)
+{
+    const std::vector<size_t> time_index = {sample.index};
+
+    const std::vector<size_t> time_height_index = {sample.index, 0};
+    std::vector<size_t> time_height_size  = {1, 0};
+
+    std::vector<double>::const_iterator data = sample.data.begin();
+
+    for (Mask_map::const_iterator it=masks.begin(); it!=masks.end(); ++it)
+    {
+        // shortcut
+        const Mask* m = &it->second;
+
+        // put the data into the NetCDF file
+        m->t_var   .putVar(time_index, &sample.time     );
+        m->iter_var.putVar(time_index, &sample.iteration);
+
+        for (Prof_map::const_iterator it2=m->profs.begin(); it2!=m->profs.end(); ++it2)
+        {
+            time_height_size[1] = it2->second.ncvar.getDim(1).getSize();
+            it2->second.ncvar.putVar(time_height_index, time_height_size, &data[grid->kstart]);
+            data += grid->kcells;
+        }
+
+        for (Time_series_map::const_iterator it2=m->tseries.begin(); it2!=m->tseries.end(); ++it2)
+        {
+            it2->second.ncvar.putVar(time_index, &data[0]);
+            ++data;
+        }
+
+        // Synchronize the NetCDF file
+        // BvS: only the last netCDF4-c++ includes the NcFile->sync()
+        //      for now use sync() from the netCDF-C library to support older NetCDF4-c++ versions
+        //m->dataFile->sync();
+        if (sample.sync)
             nc_sync(m->dataFile->getId());
+    }
+}
+
+/**
+ * This function is run by the writer thread, which writes the queued samples to the NetCDF files
+ * in the background, until the writer is stopped and the queue is empty.
+ */
+void Stats::run_writer()
+{
+    std::unique_lock<std::mutex> lock(writer_mutex);
+
+    while (true)
+    {
+        while (writer_queue.empty() && !writer_stop)
+            writer_cond.wait(lock);
+
+        if (writer_queue.empty())
+            return;
+
+        // the model does not modify the first sample, it can be written without the lock
+        const Stats_sample& sample = writer_queue.front();
+        lock.unlock();
+
+        bool failed = false;
+        std::string message;
+        try
+        {
+            write_sample(sample);
+        }
+        catch (NcException& e)
+        {
+            failed  = true;
+            message = std::string("NetCDF exception: ") + e.what();
+        }
+        catch (std::exception& e)
+        {
+            failed  = true;
+            message = e.what();
         }
+
+        lock.lock();
+        writer_queue.pop_front();
+        if (failed && !writer_error)
+        {
+            writer_error   = true;
+            writer_message = message;
+        }
+        writer_cond.notify_all();
+    }
+}
+
+void Stats::stop_writer()
+{
+    if (!writer.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        writer_stop = true;
+        writer_cond.notify_all();
     }
 
-    ++nstats;
+    writer.join();
+
+    // the samples that were queued at the end are not checked by exec
+    if (writer_error)
+        master->print_error("Writing the statistics failed: %s\n", writer_message.c_str());
 }
 
 std::string Stats::get_switch()
@@ -360,6 +550,170 @@ void Stats::get_mask(Field3d* mfield, Field3d* mfieldh, Mask* m)
               nmask, nmaskh, &nmaskbot);
 }
 
+/**
+ * This function adds the mask that is stored in mfield and mfieldh to the masks of which the
+ * statistics are calculated in a single sweep. Each mask takes one bit of the compact masks,
+ * the number of points is taken from nmask, nmaskh and nmaskbot.
+ */
+void Stats::add_active_mask(Mask* m, Field3d* mfield, Field3d* mfieldh)
+{
+    const int n = active_masks.size();
+
+    if (n == max_active_masks)
+    {
+        master->print_error("No more than %d statistics masks can be active\n", max_active_masks);
+        throw 1;
+    }
+
+    if (n == 0)
+    {
+        mask_bits   .assign(grid->ncells , 0);
+        mask_bitsh  .assign(grid->ncells , 0);
+        mask_bitsbot.assign(grid->ijcells, 0);
+    }
+
+    const unsigned char bit = 1 << n;
+
+    for (int ijk=0; ijk<grid->ncells; ++ijk)
+    {
+        if (mfield->data[ijk] != 0.)
+            mask_bits[ijk] |= bit;
+        if (mfieldh->data[ijk] != 0.)
+            mask_bitsh[ijk] |= bit;
+    }
+
+    for (int ij=0; ij<grid->ijcells; ++ij)
+        if (mfieldh->databot[ij] != 0.)
+            mask_bitsbot[ij] |= bit;
+
+    // the runs of the cells in the masks have changed
+    mask_runs.clear();
+
+    Active_mask am;
+    am.mask = m;
+    am.nmask .assign(nmask , nmask +grid->kcells);
+    am.nmaskh.assign(nmaskh, nmaskh+grid->kcells);
+    am.nmaskbot = nmaskbot;
+
+    active_masks.push_back(am);
+}
+
+void Stats::clear_active_masks()
+{
+    active_masks.clear();
+    mask_runs.clear();
+}
+
+int Stats::get_nmasks()
+{
+    return active_masks.size();
+}
+
+Mask* Stats::get_active_mask(const int n)
+{
+    return active_masks[n].mask;
+}
+
+const int* Stats::get_nmask(const int n, const int zloc)
+{
+    return (zloc == 1) ? active_masks[n].nmaskh.data() : active_masks[n].nmask.data();
+}
+
+/**
+ * This function returns, per level, the runs of consecutive cells along the rows that the kernels
+ * visit for the compact mask bits, interpolated horizontally with the neighbouring cell at shift.
+ * Masks that contain all cells with full weight, such as the default mask, are visited with one run
+ * per row. The other masks are visited only in the runs of cells that are in any of them, such that
+ * a sparse mask only reads its own cells. Each run stores the masks that it is visited for, so each
+ * mask sees its cells in the same order. The runs are calculated at their first use and kept until
+ * the active masks change.
+ */
+const Stats::Mask_runs& Stats::get_mask_runs(const unsigned char* const restrict bits, const int shift)
+{
+    const std::pair<const unsigned char*, int> key(bits, shift);
+
+    std::map<std::pair<const unsigned char*, int>, Mask_runs>::const_iterator it = mask_runs.find(key);
+    if (it != mask_runs.end())
+        return it->second;
+
+    const int jj = grid->icells;
+    const int kk = grid->ijcells;
+
+    // the surface mask has a single level
+    const int nlevels = (bits == mask_bitsbot.data()) ? 1 : grid->kcells;
+
+    // find the masks that contain all cells with full weight
+    unsigned int dense = (1u << get_nmasks()) - 1;
+    for (int k=0; k<nlevels && dense; ++k)
+        for (int j=grid->jstart; j<grid->jend; j++)
+            for (int i=grid->istart; i<grid->iend; i++)
+            {
+                const int ijk = i + j*jj + k*kk;
+                dense &= bits[ijk] & bits[ijk+shift];
+            }
+
+    const unsigned int sparse = ((1u << get_nmasks()) - 1) & ~dense;
+
+    Mask_runs& runs = mask_runs[key];
+
+    for (int k=0; k<nlevels; ++k)
+    {
+        runs.kbegin.push_back(runs.begin.size());
+
+        for (int j=grid->jstart; j<grid->jend; j++)
+        {
+            if (dense)
+            {
+                runs.begin.push_back(grid->istart + j*jj + k*kk);
+                runs.end  .push_back(grid->iend   + j*jj + k*kk);
+                runs.masks.push_back(dense);
+            }
+
+            if (!sparse)
+                continue;
+
+            bool inrun = false;
+            for (int i=grid->istart; i<grid->iend; i++)
+            {
+                const int ijk = i + j*jj + k*kk;
+                const bool inmask = ((bits[ijk] | bits[ijk+shift]) & sparse) != 0;
+                if (inmask && !inrun)
+                {
+                    runs.begin.push_back(ijk);
+                    runs.masks.push_back(sparse);
+                }
+                else if (!inmask && inrun)
+                    runs.end.push_back(ijk);
+                inrun = inmask;
+            }
+
+            if (inrun)
+                runs.end.push_back(grid->iend + j*jj + k*kk);
+        }
+    }
+    runs.kbegin.push_back(runs.begin.size());
+
+    return runs;
+}
+
+Mask_data Stats::get_profs(const std::string name)
+{
+    Mask_data data;
+    for (std::vector<Active_mask>::const_iterator it=active_masks.begin(); it!=active_masks.end(); ++it)
+        data.push_back(it->mask->profs[name].data);
+
+    return data;
+}
+
+Mask_data Stats::get_time_series(const std::string name)
+{
+    Mask_data data;
+    for (std::vector<Active_mask>::const_iterator it=active_masks.begin(); it!=active_masks.end(); ++it)
+        data.push_back(&it->mask->tseries[name].data);
+
+    return data;
+}
+
 // COMPUTATIONAL KERNELS BELOW
 void Stats::calc_mask(double* restrict mask, double* restrict maskh, double* restrict maskbot,
                       int* restrict nmask, int* restrict nmaskh, int* restrict nmaskbot)
@@ -384,70 +738,81 @@ void Stats::calc_mask(double* restrict mask, double* restrict maskh, double* res
     *nmaskbot = ijtot;
 }
 
-void Stats::calc_area(double* restrict area, const int loc[3], int* restrict nmask)
+void Stats::calc_area(const Mask_data& area, const int loc[3])
 {
     const int ijtot = grid->itot*grid->jtot;
 
-    for (int k=grid->kstart; k<grid->kend+loc[2]; k++)
+    for (int n=0; n<get_nmasks(); ++n)
     {
-        if (nmask[k] > nthres)
-            area[k] = (double)(nmask[k]) / (double)ijtot;
-        else
-            area[k] = 0.;
+        const int* nmask = get_nmask(n, loc[2]);
+
+        for (int k=grid->kstart; k<grid->kend+loc[2]; k++)
+        {
+            if (nmask[k] > nthres)
+                area[n][k] = (double)(nmask[k]) / (double)ijtot;
+            else
+                area[n][k] = 0.;
+        }
     }
 }
 
-void Stats::calc_mean(double* const restrict prof, const double* const restrict data,
-                      const double offset, const int loc[3],
-                      const double* const restrict mask, const int * const restrict nmask)
+void Stats::calc_mean(const Mask_data& prof, const double* const restrict data,
+                      const double offset, const int loc[3])
 {
     const int jj = grid->icells;
-    const int kk = grid->ijcells;
+    const int nmasks = get_nmasks();
+    const int shift  = get_mask_shift(loc, jj);
+    const unsigned char* restrict bits = (loc[2] == 1) ? mask_bitsh.data() : mask_bits.data();
+    const Mask_runs& runs = get_mask_runs(bits, shift);
+
+    double sum[max_active_masks];
 
     for (int k=1; k<grid->kcells; k++)
     {
-        prof[k] = 0.;
-        for (int j=grid->jstart; j<grid->jend; j++)
-#pragma ivdep
-            for (int i=grid->istart; i<grid->iend; i++)
+        for (int n=0; n<nmasks; ++n)
+            sum[n] = 0.;
+
+        for (int r=runs.kbegin[k]; r<runs.kbegin[k+1]; ++r)
+            for (int ijk=runs.begin[r]; ijk<runs.end[r]; ++ijk)
             {
-                const int ijk  = i + j*jj + k*kk;
-                prof[k] += mask[ijk]*(data[ijk] + offset);
+                const unsigned int full = bits[ijk] & bits[ijk+shift] & runs.masks[r];
+                const unsigned int half = (bits[ijk] ^ bits[ijk+shift]) & runs.masks[r];
+                add_to_masks(sum, data[ijk] + offset, full, half);
             }
-    }
-
-    master->sum(prof, grid->kcells);
 
-    for (int k=1; k<grid->kcells; k++)
-    {
-        if (nmask[k] > nthres)
-            prof[k] /= (double)(nmask[k]);
-        else
-            prof[k] = NC_FILL_DOUBLE;
+        for (int n=0; n<nmasks; ++n)
+            prof[n][k] = sum[n];
     }
+
+    for (int n=0; n<nmasks; ++n)
+        reduce_prof(prof[n], grid->kcells, get_nmask(n, loc[2]), 1, 0);
 }
 
-void Stats::calc_mean2d(double* const restrict mean, const double* const restrict data,
-                        const double offset,
-                        const double* const restrict mask, const int * const restrict nmask)
+void Stats::calc_mean2d(const Mask_data& mean, const double* const restrict data,
+                        const double offset)
 {
-    const int jj = grid->icells;
+    const int nmasks = get_nmasks();
+    const Mask_runs& runs = get_mask_runs(mask_bitsbot.data(), 0);
+
+    double sum[max_active_masks];
+
+    for (int n=0; n<nmasks; ++n)
+        sum[n] = 0.;
+
+    for (int r=runs.kbegin[0]; r<runs.kbegin[1]; ++r)
+        for (int ij=runs.begin[r]; ij<runs.end[r]; ++ij)
+            add_to_masks(sum, data[ij] + offset, mask_bitsbot[ij] & runs.masks[r], 0);
 
-    if (*nmask > nthres)
+    for (int n=0; n<nmasks; ++n)
     {
-        *mean = 0.;
-        for (int j=grid->jstart; j<grid->jend; j++)
-#pragma ivdep
-            for (int i=grid->istart; i<grid->iend; i++)
-            {
-                const int ij = i + j*jj;
-                *mean += mask[ij]*(data[ij] + offset);
-            }
-        master->sum(mean,1);
-        *mean /= (double)*nmask;
+        if (active_masks[n].nmaskbot > nthres)
+        {
+            *mean[n] = sum[n];
+            reduce_prof(mean[n], 1, &active_masks[n].nmaskbot, 0, 0);
+        }
+        else
+            *mean[n] = NC_FILL_DOUBLE;
     }
-    else
-        *mean = NC_FILL_DOUBLE;
 }
 
 void Stats::calc_sorted_prof(double* restrict data, double* restrict bin, double* restrict prof)
@@ -576,71 +941,203 @@ void Stats::calc_sorted_prof(double* restrict data, double* restrict bin, double
 }
 
 // \TODO the count function assumes that the variable to count is at the mask location
-void Stats::calc_count(double* restrict data, double* restrict prof, double threshold,
-                       double* restrict mask, int* restrict nmask)
+void Stats::calc_count(const double* const restrict data, const Mask_data& prof, const double threshold)
 {
-    const int jj = grid->icells;
-    const int kk = grid->ijcells;
+    const int nmasks = get_nmasks();
+    const Mask_runs& runs = get_mask_runs(mask_bits.data(), 0);
+
+    double sum[max_active_masks];
 
     for (int k=0; k<grid->kcells; ++k)
     {
-        prof[k] = 0.;
-        for (int j=grid->jstart; j<grid->jend; ++j)
-#pragma ivdep
-            for (int i=grid->istart; i<grid->iend; ++i)
+        for (int n=0; n<nmasks; ++n)
+            sum[n] = 0.;
+
+        for (int r=runs.kbegin[k]; r<runs.kbegin[k+1]; ++r)
+            for (int ijk=runs.begin[r]; ijk<runs.end[r]; ++ijk)
             {
-                const int ijk = i + j*jj + k*kk;
                 if (data[ijk] > threshold)
-                    prof[k] += mask[ijk]*1.;
+                    add_to_masks(sum, 1., mask_bits[ijk] & runs.masks[r], 0);
             }
-    }
 
-    master->sum(prof, grid->kcells);
-
-    for (int k=0; k<grid->kcells; k++)
-    {
-        if (nmask[k] > nthres)
-            prof[k] /= (double)(nmask[k]);
-        else
-            prof[k] = NC_FILL_DOUBLE;
+        for (int n=0; n<nmasks; ++n)
+            prof[n][k] = sum[n];
     }
+
+    for (int n=0; n<nmasks; ++n)
+        reduce_prof(prof[n], grid->kcells, get_nmask(n, 0), 0, 0);
 }
 
-void Stats::calc_moment(double* restrict data, double* restrict datamean, double* restrict prof, double power, const int loc[3],
-                        double* restrict mask, int* restrict nmask)
+void Stats::calc_moment(const double* const restrict data, const Mask_data& datamean, const Mask_data& prof,
+                        const double power, const int loc[3])
 {
     const int jj = grid->icells;
-    const int kk = grid->ijcells;
+    const int nmasks = get_nmasks();
+    const int shift  = get_mask_shift(loc, jj);
+    const unsigned char* restrict bits = (loc[2] == 1) ? mask_bitsh.data() : mask_bits.data();
+    const Mask_runs& runs = get_mask_runs(bits, shift);
+
+    // the means have to be summed before they can be used
+    while (is_pending(datamean))
+        reduce_pending();
+
+    double sum[max_active_masks];
 
     for (int k=grid->kstart; k<grid->kend+1; ++k)
     {
-        prof[k] = 0.;
-        for (int j=grid->jstart; j<grid->jend; ++j)
-#pragma ivdep
-            for (int i=grid->istart; i<grid->iend; ++i)
+        for (int n=0; n<nmasks; ++n)
+            sum[n] = 0.;
+
+        for (int r=runs.kbegin[k]; r<runs.kbegin[k+1]; ++r)
+            for (int ijk=runs.begin[r]; ijk<runs.end[r]; ++ijk)
             {
-                const int ijk = i + j*jj + k*kk;
-                prof[k] += mask[ijk]*std::pow(data[ijk]-datamean[k], power);
+                const unsigned int full = bits[ijk] & bits[ijk+shift] & runs.masks[r];
+                const unsigned int half = (bits[ijk] ^ bits[ijk+shift]) & runs.masks[r];
+
+                // the moment is taken around the mean of each mask
+                for (int n=0; (full | half) >> n; ++n)
+                {
+                    if ((full >> n) & 1)
+                        sum[n] += std::pow(data[ijk]-datamean[n][k], power);
+                    else if ((half >> n) & 1)
+                        sum[n] += 0.5*std::pow(data[ijk]-datamean[n][k], power);
+                }
             }
+
+        for (int n=0; n<nmasks; ++n)
+            prof[n][k] = sum[n];
     }
 
-    master->sum(prof, grid->kcells);
+    for (int n=0; n<nmasks; ++n)
+        reduce_prof(prof[n], grid->kcells, get_nmask(n, loc[2]), 1, 0);
+}
+
+/**
+ * This function calculates the mean and the second, third and fourth central moments in a single
+ * pass. The sums are taken around the first cell in the mask at each level, which is close enough
+ * to the mean to avoid cancellation. They are converted into local central moments that are shifted
+ * to the mean of the domain once that is summed over the processes.
+ */
+void Stats::calc_moments(const Mask_data& prof, const Mask_data& prof2,
+                         const Mask_data& prof3, const Mask_data& prof4,
+                         const double* const restrict data, const double offset, const int loc[3])
+{
+    const int jj = grid->icells;
+    const int nmasks = get_nmasks();
+    const int mshift = get_mask_shift(loc, jj);
+    const unsigned char* restrict bits = (loc[2] == 1) ? mask_bitsh.data() : mask_bits.data();
+    const Mask_runs& runs = get_mask_runs(bits, mshift);
+
+    std::vector<Pending_moments> moments(nmasks);
+    for (int n=0; n<nmasks; ++n)
+    {
+        moments[n].mean    = prof[n];
+        moments[n].offset  = offset;
+        moments[n].prof[0] = prof2[n];
+        moments[n].prof[1] = prof3[n];
+        moments[n].prof[2] = prof4[n];
+        moments[n].nmask   = get_nmask(n, loc[2]);
+        moments[n].sumw   .assign(grid->kcells, 0.);
+        moments[n].meanloc.assign(grid->kcells, 0.);
+    }
+
+    double shift[max_active_masks];
+    double sum  [max_active_masks];
+    double sumw [max_active_masks];
+    double a1   [max_active_masks];
+    double a2   [max_active_masks];
+    double a3   [max_active_masks];
+    double a4   [max_active_masks];
 
     for (int k=1; k<grid->kcells; k++)
     {
-        if (nmask[k] > nthres)
-            prof[k] /= (double)(nmask[k]);
-        else
-            prof[k] = NC_FILL_DOUBLE;
+        for (int n=0; n<nmasks; ++n)
+        {
+            shift[n] = 0.;
+            sum  [n] = 0.;
+            sumw [n] = 0.;
+            a1   [n] = 0.;
+            a2   [n] = 0.;
+            a3   [n] = 0.;
+            a4   [n] = 0.;
+        }
+
+        // masks of which the shift is set at this level
+        unsigned int found = 0;
+
+        for (int r=runs.kbegin[k]; r<runs.kbegin[k+1]; ++r)
+            for (int ijk=runs.begin[r]; ijk<runs.end[r]; ++ijk)
+            {
+                const unsigned int full = bits[ijk] & bits[ijk+mshift] & runs.masks[r];
+                const unsigned int half = (bits[ijk] ^ bits[ijk+mshift]) & runs.masks[r];
+
+                for (int n=0; (full | half) >> n; ++n)
+                {
+                    double m;
+                    if ((full >> n) & 1)
+                        m = 1.;
+                    else if ((half >> n) & 1)
+                        m = 0.5;
+                    else
+                        continue;
+
+                    if (!((found >> n) & 1))
+                    {
+                        shift[n] = data[ijk];
+                        found |= 1 << n;
+                    }
+
+                    const double y  = data[ijk] - shift[n];
+                    const double y2 = y*y;
+                    sum [n] += m*(data[ijk] + offset);
+                    sumw[n] += m;
+                    a1  [n] += m*y;
+                    a2  [n] += m*y2;
+                    a3  [n] += m*y2*y;
+                    a4  [n] += m*y2*y2;
+                }
+            }
+
+        for (int n=0; n<nmasks; ++n)
+        {
+            prof[n][k] = sum[n];
+
+            if (sumw[n] > 0.)
+            {
+                const double ym = a1[n]/sumw[n];
+                moments[n].sumw   [k] = sumw[n];
+                moments[n].meanloc[k] = shift[n] + ym;
+                prof2[n][k] = a2[n] - ym*a1[n];
+                prof3[n][k] = a3[n] - 3.*ym*a2[n] + 2.*sumw[n]*ym*ym*ym;
+                prof4[n][k] = a4[n] - 4.*ym*a3[n] + 6.*ym*ym*a2[n] - 3.*sumw[n]*ym*ym*ym*ym;
+            }
+            else
+            {
+                prof2[n][k] = 0.;
+                prof3[n][k] = 0.;
+                prof4[n][k] = 0.;
+            }
+        }
+    }
+
+    // the moments are completed after the means are summed
+    for (int n=0; n<nmasks; ++n)
+    {
+        pending_moments.push_back(moments[n]);
+        reduce_prof(prof[n], grid->kcells, get_nmask(n, loc[2]), 1, 0);
     }
 }
 
-void Stats::calc_flux_2nd(double* restrict data, double* restrict datamean, double* restrict w, double* restrict wmean,
-                          double* restrict prof, double* restrict tmp1, const int loc[3],
-                          double* restrict mask, int* restrict nmask)
+void Stats::calc_flux_2nd(const double* const restrict data, const Mask_data& datamean,
+                          double* const restrict w, const Mask_data& wmean,
+                          const Mask_data& prof, double* const restrict tmp1, const int loc[3])
 {
     const int jj = grid->icells;
     const int kk = grid->ijcells;
+    const int nmasks = get_nmasks();
+    const int shift  = get_mask_shift(loc, jj);
+    const unsigned char* restrict bits = mask_bitsh.data();
+    const Mask_runs& runs = get_mask_runs(bits, shift);
 
     // set a pointer to the field that contains w, either interpolated or the original
     double* restrict calcw = w;
@@ -650,6 +1147,10 @@ void Stats::calc_flux_2nd(double* restrict data, double* restrict datamean, doub
     const int uwloc[3] = {1,0,1};
     const int vwloc[3] = {0,1,1};
 
+    // the means have to be summed before they can be used
+    while (is_pending(datamean) || is_pending(wmean))
+        reduce_pending();
+
     if (loc[0] == 1)
     {
         grid->interpolate_2nd(tmp1, w, wloc, uwloc);
@@ -661,38 +1162,49 @@ void Stats::calc_flux_2nd(double* restrict data, double* restrict datamean, doub
         calcw = tmp1;
     }
 
+    double sum[max_active_masks];
+
     for (int k=grid->kstart; k<grid->kend+1; ++k)
     {
-        prof[k] = 0.;
-        for (int j=grid->jstart; j<grid->jend; ++j)
-#pragma ivdep
-            for (int i=grid->istart; i<grid->iend; ++i)
+        for (int n=0; n<nmasks; ++n)
+            sum[n] = 0.;
+
+        for (int r=runs.kbegin[k]; r<runs.kbegin[k+1]; ++r)
+            for (int ijk=runs.begin[r]; ijk<runs.end[r]; ++ijk)
             {
-                const int ijk  = i + j*jj + k*kk;
-                prof[k] += mask[ijk]*(0.5*(data[ijk-kk]+data[ijk])-0.5*(datamean[k-1]+datamean[k]))*(calcw[ijk]-wmean[k]);
-                // prof[k] += mask[ijk]*0.5*(data[ijk-kk]+data[ijk])*calcw[ijk];
-            }
-    }
+                const unsigned int full = bits[ijk] & bits[ijk+shift] & runs.masks[r];
+                const unsigned int half = (bits[ijk] ^ bits[ijk+shift]) & runs.masks[r];
 
-    master->sum(prof, grid->kcells);
+                // the flux is taken around the means of each mask
+                for (int n=0; (full | half) >> n; ++n)
+                {
+                    if ((full >> n) & 1)
+                        sum[n] += (0.5*(data[ijk-kk]+data[ijk])-0.5*(datamean[n][k-1]+datamean[n][k]))*(calcw[ijk]-wmean[n][k]);
+                    else if ((half >> n) & 1)
+                        sum[n] += 0.5*(0.5*(data[ijk-kk]+data[ijk])-0.5*(datamean[n][k-1]+datamean[n][k]))*(calcw[ijk]-wmean[n][k]);
+                }
+            }
 
-    for (int k=1; k<grid->kcells; ++k)
-    {
-        if (nmask[k] > nthres && datamean[k-1] != NC_FILL_DOUBLE && datamean[k] != NC_FILL_DOUBLE)
-            prof[k] /= (double)(nmask[k]);
-        else
-            prof[k] = NC_FILL_DOUBLE;
+        for (int n=0; n<nmasks; ++n)
+            prof[n][k] = sum[n];
     }
+
+    for (int n=0; n<nmasks; ++n)
+        reduce_prof(prof[n], grid->kcells, get_nmask(n, 1), 1, datamean[n]);
 }
 
-void Stats::calc_flux_4th(double* restrict data, double* restrict w, double* restrict prof, double* restrict tmp1, const int loc[3],
-                          double* restrict mask, int* restrict nmask)
+void Stats::calc_flux_4th(const double* const restrict data, double* const restrict w,
+                          const Mask_data& prof, double* const restrict tmp1, const int loc[3])
 {
     using namespace Finite_difference::O4;
 
-    const int jj  = 1*grid->icells;
+    const int jj  = grid->icells;
     const int kk1 = 1*grid->ijcells;
     const int kk2 = 2*grid->ijcells;
+    const int nmasks = get_nmasks();
+    const int shift  = get_mask_shift(loc, jj);
+    const unsigned char* restrict bits = mask_bitsh.data();
+    const Mask_runs& runs = get_mask_runs(bits, shift);
 
     // set a pointer to the field that contains w, either interpolated or the original
     double* restrict calcw = w;
@@ -713,250 +1225,252 @@ void Stats::calc_flux_4th(double* restrict data, double* restrict w, double* res
         calcw = tmp1;
     }
 
+    double sum[max_active_masks];
+
     for (int k=grid->kstart; k<grid->kend+1; ++k)
     {
-        prof[k] = 0.;
-        for (int j=grid->jstart; j<grid->jend; ++j)
-#pragma ivdep
-            for (int i=grid->istart; i<grid->iend; ++i)
+        for (int n=0; n<nmasks; ++n)
+            sum[n] = 0.;
+
+        for (int r=runs.kbegin[k]; r<runs.kbegin[k+1]; ++r)
+            for (int ijk=runs.begin[r]; ijk<runs.end[r]; ++ijk)
             {
-                const int ijk = i + j*jj + k*kk1;
-                prof[k] += mask[ijk]*(ci0*data[ijk-kk2] + ci1*data[ijk-kk1] + ci2*data[ijk] + ci3*data[ijk+kk1])*calcw[ijk];
+                const unsigned int full = bits[ijk] & bits[ijk+shift] & runs.masks[r];
+                const unsigned int half = (bits[ijk] ^ bits[ijk+shift]) & runs.masks[r];
+                add_to_masks(sum, (ci0*data[ijk-kk2] + ci1*data[ijk-kk1] + ci2*data[ijk] + ci3*data[ijk+kk1])*calcw[ijk], full, half);
             }
-    }
-
-    master->sum(prof, grid->kcells);
 
-    for (int k=1; k<grid->kcells; k++)
-    {
-        if (nmask[k] > nthres)
-            prof[k] /= (double)(nmask[k]);
-        else
-            prof[k] = NC_FILL_DOUBLE;
+        for (int n=0; n<nmasks; ++n)
+            prof[n][k] = sum[n];
     }
+
+    for (int n=0; n<nmasks; ++n)
+        reduce_prof(prof[n], grid->kcells, get_nmask(n, 1), 1, 0);
 }
 
-void Stats::calc_grad_2nd(double* restrict data, double* restrict prof, double* restrict dzhi, const int loc[3],
-                          double* restrict mask, int* restrict nmask)
+void Stats::calc_grad_2nd(const double* const restrict data, const Mask_data& prof,
+                          const double* const restrict dzhi, const int loc[3])
 {
     const int jj = grid->icells;
     const int kk = grid->ijcells;
+    const int nmasks = get_nmasks();
+    const int shift  = get_mask_shift(loc, jj);
+    const unsigned char* restrict bits = mask_bitsh.data();
+    const Mask_runs& runs = get_mask_runs(bits, shift);
+
+    double sum[max_active_masks];
 
     for (int k=grid->kstart; k<grid->kend+1; ++k)
     {
-        prof[k] = 0.;
-        for (int j=grid->jstart; j<grid->jend; ++j)
-#pragma ivdep
-            for (int i=grid->istart; i<grid->iend; ++i)
+        for (int n=0; n<nmasks; ++n)
+            sum[n] = 0.;
+
+        for (int r=runs.kbegin[k]; r<runs.kbegin[k+1]; ++r)
+            for (int ijk=runs.begin[r]; ijk<runs.end[r]; ++ijk)
             {
-                const int ijk = i + j*jj + k*kk;
-                prof[k] += mask[ijk]*(data[ijk]-data[ijk-kk])*dzhi[k];
+                const unsigned int full = bits[ijk] & bits[ijk+shift] & runs.masks[r];
+                const unsigned int half = (bits[ijk] ^ bits[ijk+shift]) & runs.masks[r];
+                add_to_masks(sum, (data[ijk]-data[ijk-kk])*dzhi[k], full, half);
             }
-    }
-
-    master->sum(prof, grid->kcells);
 
-    for (int k=1; k<grid->kcells; k++)
-    {
-        if (nmask[k] > nthres)
-            prof[k] /= (double)(nmask[k]);
-        else
-            prof[k] = NC_FILL_DOUBLE;
+        for (int n=0; n<nmasks; ++n)
+            prof[n][k] = sum[n];
     }
+
+    for (int n=0; n<nmasks; ++n)
+        reduce_prof(prof[n], grid->kcells, get_nmask(n, 1), 1, 0);
 }
 
-void Stats::calc_grad_4th(double* restrict data, double* restrict prof, double* restrict dzhi4, const int loc[3],
-                          double* restrict mask, int* restrict nmask)
+void Stats::calc_grad_4th(const double* const restrict data, const Mask_data& prof,
+                          const double* const restrict dzhi4, const int loc[3])
 {
     using namespace Finite_difference::O4;
 
-    const int jj  = 1*grid->icells;
+    const int jj  = grid->icells;
     const int kk1 = 1*grid->ijcells;
     const int kk2 = 2*grid->ijcells;
+    const int nmasks = get_nmasks();
+    const int shift  = get_mask_shift(loc, jj);
+    const unsigned char* restrict bits = mask_bitsh.data();
+    const Mask_runs& runs = get_mask_runs(bits, shift);
+
+    double sum[max_active_masks];
 
     for (int k=grid->kstart; k<grid->kend+1; ++k)
     {
-        prof[k] = 0.;
-        for (int j=grid->jstart; j<grid->jend; ++j)
-#pragma ivdep
-            for (int i=grid->istart; i<grid->iend; ++i)
+        for (int n=0; n<nmasks; ++n)
+            sum[n] = 0.;
+
+        for (int r=runs.kbegin[k]; r<runs.kbegin[k+1]; ++r)
+            for (int ijk=runs.begin[r]; ijk<runs.end[r]; ++ijk)
             {
-                const int ijk = i + j*jj + k*kk1;
-                prof[k] += mask[ijk]*(cg0*data[ijk-kk2] + cg1*data[ijk-kk1] + cg2*data[ijk] + cg3*data[ijk+kk1])*dzhi4[k];
+                const unsigned int full = bits[ijk] & bits[ijk+shift] & runs.masks[r];
+                const unsigned int half = (bits[ijk] ^ bits[ijk+shift]) & runs.masks[r];
+                add_to_masks(sum, (cg0*data[ijk-kk2] + cg1*data[ijk-kk1] + cg2*data[ijk] + cg3*data[ijk+kk1])*dzhi4[k], full, half);
             }
-    }
-
-    master->sum(prof, grid->kcells);
 
-    for (int k=1; k<grid->kcells; k++)
-    {
-        if (nmask[k] > nthres)
-            prof[k] /= (double)(nmask[k]);
-        else
-            prof[k] = NC_FILL_DOUBLE;
+        for (int n=0; n<nmasks; ++n)
+            prof[n][k] = sum[n];
     }
+
+    for (int n=0; n<nmasks; ++n)
+        reduce_prof(prof[n], grid->kcells, get_nmask(n, 1), 1, 0);
 }
 
-void Stats::calc_diff_4th(double* restrict data, double* restrict prof, double* restrict dzhi4, double visc, const int loc[3],
-                          double* restrict mask, int* restrict nmask)
+void Stats::calc_diff_4th(const double* const restrict data, const Mask_data& prof,
+                          const double* const restrict dzhi4, const double visc, const int loc[3])
 {
     using namespace Finite_difference::O4;
 
-    const int jj  = 1*grid->icells;
+    const int jj  = grid->icells;
     const int kk1 = 1*grid->ijcells;
     const int kk2 = 2*grid->ijcells;
+    const int nmasks = get_nmasks();
+    const int shift  = get_mask_shift(loc, jj);
+    const unsigned char* restrict bits = mask_bitsh.data();
+    const Mask_runs& runs = get_mask_runs(bits, shift);
+
+    double sum[max_active_masks];
 
     for (int k=grid->kstart; k<grid->kend+1; ++k)
     {
-        prof[k] = 0.;
-        for (int j=grid->jstart; j<grid->jend; ++j)
-#pragma ivdep
-            for (int i=grid->istart; i<grid->iend; ++i)
+        for (int n=0; n<nmasks; ++n)
+            sum[n] = 0.;
+
+        for (int r=runs.kbegin[k]; r<runs.kbegin[k+1]; ++r)
+            for (int ijk=runs.begin[r]; ijk<runs.end[r]; ++ijk)
             {
-                const int ijk = i + j*jj + k*kk1;
-                prof[k] -= mask[ijk]*visc*(cg0*data[ijk-kk2] + cg1*data[ijk-kk1] + cg2*data[ijk] + cg3*data[ijk+kk1])*dzhi4[k];
+                const unsigned int full = bits[ijk] & bits[ijk+shift] & runs.masks[r];
+                const unsigned int half = (bits[ijk] ^ bits[ijk+shift]) & runs.masks[r];
+                add_to_masks(sum, -visc*(cg0*data[ijk-kk2] + cg1*data[ijk-kk1] + cg2*data[ijk] + cg3*data[ijk+kk1])*dzhi4[k], full, half);
             }
-    }
-
-    master->sum(prof, grid->kcells);
 
-    for (int k=1; k<grid->kcells; k++)
-    {
-        if (nmask[k] > nthres)
-            prof[k] /= (double)(nmask[k]);
-        else
-            prof[k] = NC_FILL_DOUBLE;
+        for (int n=0; n<nmasks; ++n)
+            prof[n][k] = sum[n];
     }
+
+    for (int n=0; n<nmasks; ++n)
+        reduce_prof(prof[n], grid->kcells, get_nmask(n, 1), 1, 0);
 }
 
-void Stats::calc_diff_2nd(double* restrict data, double* restrict prof, double* restrict dzhi, double visc, const int loc[3],
-                          double* restrict mask, int* restrict nmask)
+void Stats::calc_diff_2nd(const double* const restrict data, const Mask_data& prof,
+                          const double* const restrict dzhi, const double visc, const int loc[3])
 {
     const int jj = grid->icells;
     const int kk = grid->ijcells;
+    const int nmasks = get_nmasks();
+    const int shift  = get_mask_shift(loc, jj);
+    const unsigned char* restrict bits = mask_bitsh.data();
+    const Mask_runs& runs = get_mask_runs(bits, shift);
+
+    double sum[max_active_masks];
 
     for (int k=grid->kstart; k<grid->kend+1; ++k)
     {
-        prof[k] = 0.;
-        for (int j=grid->jstart; j<grid->jend; ++j)
-#pragma ivdep
-            for (int i=grid->istart; i<grid->iend; ++i)
+        for (int n=0; n<nmasks; ++n)
+            sum[n] = 0.;
+
+        for (int r=runs.kbegin[k]; r<runs.kbegin[k+1]; ++r)
+            for (int ijk=runs.begin[r]; ijk<runs.end[r]; ++ijk)
             {
-                const int ijk = i + j*jj + k*kk;
-                prof[k] -= mask[ijk]*visc*(data[ijk] - data[ijk-kk])*dzhi[k];
+                const unsigned int full = bits[ijk] & bits[ijk+shift] & runs.masks[r];
+                const unsigned int half = (bits[ijk] ^ bits[ijk+shift]) & runs.masks[r];
+                add_to_masks(sum, -visc*(data[ijk] - data[ijk-kk])*dzhi[k], full, half);
             }
-    }
-
-    master->sum(prof, grid->kcells);
 
-    for (int k=1; k<grid->kcells; k++)
-    {
-        if (nmask[k] > nthres)
-            prof[k] /= (double)(nmask[k]);
-        else
-            prof[k] = NC_FILL_DOUBLE;
+        for (int n=0; n<nmasks; ++n)
+            prof[n][k] = sum[n];
     }
+
+    for (int n=0; n<nmasks; ++n)
+        reduce_prof(prof[n], grid->kcells, get_nmask(n, 1), 1, 0);
 }
 
 
-void Stats::calc_diff_2nd(double* restrict data, double* restrict w, double* restrict evisc,
-                          double* restrict prof, double* restrict dzhi,
-                          double* restrict fluxbot, double* restrict fluxtop, double tPr, const int loc[3],
-                          double* restrict mask, int* restrict nmask)
+void Stats::calc_diff_2nd(const double* const restrict data, const double* const restrict w,
+                          const double* const restrict evisc, const Mask_data& prof,
+                          const double* const restrict dzhi,
+                          const double* const restrict fluxbot, const double* const restrict fluxtop,
+                          const double tPr, const int loc[3])
 {
     const int ii = 1;
     const int jj = grid->icells;
     const int kk = grid->ijcells;
     const int kstart = grid->kstart;
     const int kend = grid->kend;
+    const int nmasks = get_nmasks();
+    const int shift  = get_mask_shift(loc, jj);
+    const unsigned char* restrict bits = mask_bitsh.data();
+    const Mask_runs& runs = get_mask_runs(bits, shift);
 
     const double dxi = 1./grid->dx;
     const double dyi = 1./grid->dy;
 
-    // bottom boundary
-    prof[kstart] = 0.;
-    for (int j=grid->jstart; j<grid->jend; ++j)
-#pragma ivdep
-        for (int i=grid->istart; i<grid->iend; ++i)
-        {
-            const int ij  = i + j*jj;
-            const int ijk = i + j*jj + kstart*kk;
-            prof[kstart] += mask[ijk]*fluxbot[ij];
-        }
+    double sum[max_active_masks];
 
-    // calculate the interior
-    if (loc[0] == 1)
+    for (int k=kstart; k<kend+1; ++k)
     {
-        for (int k=grid->kstart+1; k<grid->kend; ++k)
-        {
-            prof[k] = 0.;
-            for (int j=grid->jstart; j<grid->jend; ++j)
-#pragma ivdep
-                for (int i=grid->istart; i<grid->iend; ++i)
+        for (int n=0; n<nmasks; ++n)
+            sum[n] = 0.;
+
+        for (int r=runs.kbegin[k]; r<runs.kbegin[k+1]; ++r)
+            for (int ijk=runs.begin[r]; ijk<runs.end[r]; ++ijk)
+            {
+                const unsigned int full = bits[ijk] & bits[ijk+shift] & runs.masks[r];
+                const unsigned int half = (bits[ijk] ^ bits[ijk+shift]) & runs.masks[r];
+                double value;
+
+                // bottom and top boundary
+                if (k == kstart)
+                    value = fluxbot[ijk-kstart*kk];
+                else if (k == kend)
+                    value = fluxtop[ijk-kend*kk];
+                // calculate the interior
+                else if (loc[0] == 1)
                 {
-                    const int ijk  = i + j*jj + k*kk;
                     // evisc * (du/dz + dw/dx)
                     const double eviscu = 0.25*(evisc[ijk-ii-kk]+evisc[ijk-ii]+evisc[ijk-kk]+evisc[ijk]);
-                    prof[k] += -mask[ijk]*eviscu*( (data[ijk]-data[ijk-kk])*dzhi[k] + (w[ijk]-w[ijk-ii])*dxi );
+                    value = -eviscu*( (data[ijk]-data[ijk-kk])*dzhi[k] + (w[ijk]-w[ijk-ii])*dxi );
                 }
-        }
-    }
-    else if (loc[1] == 1)
-    {
-        for (int k=grid->kstart+1; k<grid->kend; ++k)
-        {
-            prof[k] = 0.;
-            for (int j=grid->jstart; j<grid->jend; ++j)
-#pragma ivdep
-                for (int i=grid->istart; i<grid->iend; ++i)
+                else if (loc[1] == 1)
                 {
-                    const int ijk = i + j*jj + k*kk;
                     // evisc * (dv/dz + dw/dy)
                     const double eviscv = 0.25*(evisc[ijk-jj-kk]+evisc[ijk-jj]+evisc[ijk-kk]+evisc[ijk]);
-                    prof[k] += -mask[ijk]*eviscv*( (data[ijk]-data[ijk-kk])*dzhi[k] + (w[ijk]-w[ijk-jj])*dyi );
+                    value = -eviscv*( (data[ijk]-data[ijk-kk])*dzhi[k] + (w[ijk]-w[ijk-jj])*dyi );
                 }
-        }
-    }
-    else
-    {
-        for (int k=grid->kstart+1; k<grid->kend; ++k)
-        {
-            prof[k] = 0.;
-            for (int j=grid->jstart; j<grid->jend; ++j)
-#pragma ivdep
-                for (int i=grid->istart; i<grid->iend; ++i)
+                else
                 {
-                    const int ijk = i + j*jj + k*kk;
                     const double eviscs = 0.5*(evisc[ijk-kk]+evisc[ijk])/tPr;
-                    prof[k] += -mask[ijk]*eviscs*(data[ijk]-data[ijk-kk])*dzhi[k];
+                    value = -eviscs*(data[ijk]-data[ijk-kk])*dzhi[k];
                 }
-        }
-    }
-
-    // top boundary
-    prof[kend] = 0.;
-    for (int j=grid->jstart; j<grid->jend; ++j)
-#pragma ivdep
-        for (int i=grid->istart; i<grid->iend; ++i)
-        {
-            const int ij  = i + j*jj;
-            const int ijk = i + j*jj + kend*kk;
-            prof[kend] += mask[ijk]*fluxtop[ij];
-        }
 
-    master->sum(prof, grid->kcells);
+                add_to_masks(sum, value, full, half);
+            }
 
-    for (int k=1; k<grid->kcells; k++)
-    {
-        if (nmask[k] > nthres)
-            prof[k] /= (double)(nmask[k]);
-        else
-            prof[k] = NC_FILL_DOUBLE;
+        for (int n=0; n<nmasks; ++n)
+            prof[n][k] = sum[n];
     }
+
+    for (int n=0; n<nmasks; ++n)
+        reduce_prof(prof[n], grid->kcells, get_nmask(n, 1), 1, 0);
+}
+
+void Stats::add_fluxes(const Mask_data& flux, const Mask_data& turb, const Mask_data& diff)
+{
+    for (int n=0; n<get_nmasks(); ++n)
+        add_fluxes(flux[n], turb[n], diff[n]);
 }
 
 void Stats::add_fluxes(double* restrict flux, double* restrict turb, double* restrict diff)
 {
+    // add the fluxes once their sums are known
+    if (is_pending(turb) || is_pending(diff))
+    {
+        Pending_flux pf = {flux, turb, diff};
+        pending_fluxes.push_back(pf);
+        return;
+    }
+
     for (int k=grid->kstart; k<grid->kend+1; ++k)
     {
         if (turb[k] == NC_FILL_DOUBLE || diff[k] == NC_FILL_DOUBLE)
@@ -969,67 +1483,206 @@ void Stats::add_fluxes(double* restrict flux, double* restrict turb, double* res
 /**
  * This function calculates the total domain integrated path of variable data over maskbot
  */
-void Stats::calc_path(double* restrict data, double* restrict maskbot, int* restrict nmaskbot, double* restrict path)
+void Stats::calc_path(const double* const restrict data, const Mask_data& path)
 {
-    const int jj = grid->icells;
     const int kk = grid->ijcells;
     const int kstart = grid->kstart;
+    const int nmasks = get_nmasks();
+    const Mask_runs& runs = get_mask_runs(mask_bitsbot.data(), 0);
 
-    *path = 0.;
+    double sum[max_active_masks];
 
-    if (*nmaskbot > nthres)
-    {
-        // Integrate liquid water
-        for (int j=grid->jstart; j<grid->jend; j++)
-            for (int i=grid->istart; i<grid->iend; i++)
+    for (int n=0; n<nmasks; ++n)
+        sum[n] = 0.;
+
+    // Integrate liquid water
+    for (int r=runs.kbegin[0]; r<runs.kbegin[1]; ++r)
+        for (int ij=runs.begin[r]; ij<runs.end[r]; ++ij)
+        {
+            for (int k=kstart; k<grid->kend; k++)
             {
-                const int ij = i + j*jj;
-                if (maskbot[ij] == 1)
-                    for (int k=kstart; k<grid->kend; k++)
-                    {
-                        const int ijk = i + j*jj + k*kk;
-                        *path += fields->rhoref[k] * data[ijk] * grid->dz[k];
-                    }
+                const int ijk = ij + k*kk;
+                add_to_masks(sum, fields->rhoref[k] * data[ijk] * grid->dz[k], mask_bitsbot[ij] & runs.masks[r], 0);
             }
-        *path /= (double)*nmaskbot;
-        master->sum(path, 1);
+        }
+
+    for (int n=0; n<nmasks; ++n)
+    {
+        if (active_masks[n].nmaskbot > nthres)
+        {
+            *path[n] = sum[n] / (double)active_masks[n].nmaskbot;
+            reduce_prof(path[n], 1, 0, 0, 0);
+        }
+        else
+            *path[n] = NC_FILL_DOUBLE;
     }
-    else
-        *path = NC_FILL_DOUBLE;
 }
 
 /**
  * This function calculates the vertical projected cover of variable data over maskbot
  */
-void Stats::calc_cover(double* restrict data, double* restrict maskbot, int* restrict nmaskbot, double* restrict cover, double threshold)
+void Stats::calc_cover(const double* const restrict data, const Mask_data& cover, const double threshold)
 {
-    const int jj = grid->icells;
     const int kk = grid->ijcells;
     const int kstart = grid->kstart;
+    const int nmasks = get_nmasks();
+    const Mask_runs& runs = get_mask_runs(mask_bitsbot.data(), 0);
 
-    *cover = 0.;
+    double sum[max_active_masks];
 
-    if (*nmaskbot > nthres)
-    {
-        // Per column, check if cloud present
-        for (int j=grid->jstart; j<grid->jend; j++)
-            for (int i=grid->istart; i<grid->iend; i++)
+    for (int n=0; n<nmasks; ++n)
+        sum[n] = 0.;
+
+    // Per column, check if cloud present
+    for (int r=runs.kbegin[0]; r<runs.kbegin[1]; ++r)
+        for (int ij=runs.begin[r]; ij<runs.end[r]; ++ij)
+        {
+            for (int k=kstart; k<grid->kend; k++)
             {
-                const int ij = i + j*jj;
-                if (maskbot[ij] == 1)
-                    for (int k=kstart; k<grid->kend; k++)
-                    {
-                        const int ijk = i + j*jj + k*kk;
-                        if (data[ijk]>threshold)
-                        {
-                            *cover += 1.;
-                            break;
-                        }
-                    }
+                const int ijk = ij + k*kk;
+                if (data[ijk]>threshold)
+                {
+                    add_to_masks(sum, 1., mask_bitsbot[ij] & runs.masks[r], 0);
+                    break;
+                }
             }
-        *cover /= (double)*nmaskbot;
-        master->sum(cover,1);
+        }
+
+    for (int n=0; n<nmasks; ++n)
+    {
+        if (active_masks[n].nmaskbot > nthres)
+        {
+            *cover[n] = sum[n] / (double)active_masks[n].nmaskbot;
+            reduce_prof(cover[n], 1, 0, 0, 0);
+        }
+        else
+            *cover[n] = NC_FILL_DOUBLE;
     }
-    else
-        *cover = NC_FILL_DOUBLE;
+}
+
+/**
+ * This function starts a batch in which the sums over the processes of the profiles
+ * are postponed, until a profile is needed or the batch is finished.
+ */
+void Stats::start_reductions()
+{
+    batch_reductions = true;
+}
+
+void Stats::finish_reductions()
+{
+    while (!pending_profs.empty())
+        reduce_pending();
+    batch_reductions = false;
+}
+
+void Stats::reduce_prof(double* restrict data, int n, const int* restrict nmask, int kbegin, const double* restrict datamean)
+{
+    Pending_prof prof = {data, n, nmask, kbegin, datamean};
+    pending_profs.push_back(prof);
+
+    if (!batch_reductions)
+        while (!pending_profs.empty())
+            reduce_pending();
+}
+
+bool Stats::is_pending(const double* data)
+{
+    for (std::vector<Pending_prof>::const_iterator it=pending_profs.begin(); it!=pending_profs.end(); ++it)
+        if (it->data == data)
+            return true;
+
+    for (std::vector<Pending_moments>::const_iterator it=pending_moments.begin(); it!=pending_moments.end(); ++it)
+        if (it->prof[0] == data || it->prof[1] == data || it->prof[2] == data)
+            return true;
+
+    return false;
+}
+
+bool Stats::is_pending(const Mask_data& data)
+{
+    for (Mask_data::const_iterator it=data.begin(); it!=data.end(); ++it)
+        if (is_pending(*it))
+            return true;
+
+    return false;
+}
+
+/**
+ * This function sums all pending profiles over the processes in a single collective
+ * and normalizes them with the number of points in the mask.
+ */
+void Stats::reduce_pending()
+{
+    if (pending_profs.empty())
+        return;
+
+    int nbuffer = 0;
+    for (std::vector<Pending_prof>::const_iterator it=pending_profs.begin(); it!=pending_profs.end(); ++it)
+        nbuffer += it->n;
+
+    reduce_buffer.resize(nbuffer);
+
+    // pack the local sums into the staging buffer
+    int offset = 0;
+    for (std::vector<Pending_prof>::const_iterator it=pending_profs.begin(); it!=pending_profs.end(); ++it)
+    {
+        for (int k=0; k<it->n; ++k)
+            reduce_buffer[offset+k] = it->data[k];
+        offset += it->n;
+    }
+
+    master->sum(reduce_buffer.data(), nbuffer);
+
+    // unpack and normalize the profiles
+    offset = 0;
+    for (std::vector<Pending_prof>::const_iterator it=pending_profs.begin(); it!=pending_profs.end(); ++it)
+    {
+        for (int k=0; k<it->n; ++k)
+            it->data[k] = reduce_buffer[offset+k];
+        offset += it->n;
+
+        if (it->nmask == 0)
+            continue;
+
+        for (int k=it->kbegin; k<it->n; ++k)
+        {
+            if (it->nmask[k] > nthres && (it->datamean == 0 || (it->datamean[k-1] != NC_FILL_DOUBLE && it->datamean[k] != NC_FILL_DOUBLE)))
+                it->data[k] /= (double)(it->nmask[k]);
+            else
+                it->data[k] = NC_FILL_DOUBLE;
+        }
+    }
+
+    pending_profs.clear();
+
+    // shift the local central moments to the mean of the domain and sum them in the next batch
+    std::vector<Pending_moments> moments;
+    moments.swap(pending_moments);
+    for (std::vector<Pending_moments>::const_iterator it=moments.begin(); it!=moments.end(); ++it)
+    {
+        for (int k=1; k<grid->kcells; ++k)
+        {
+            const double d  = it->mean[k] - it->offset - it->meanloc[k];
+            const double m2 = it->prof[0][k];
+            const double m3 = it->prof[1][k];
+            const double m4 = it->prof[2][k];
+
+            it->prof[0][k] = m2 + it->sumw[k]*d*d;
+            it->prof[1][k] = m3 - 3.*d*m2 - it->sumw[k]*d*d*d;
+            it->prof[2][k] = m4 - 4.*d*m3 + 6.*d*d*m2 + it->sumw[k]*d*d*d*d;
+        }
+
+        for (int n=0; n<3; ++n)
+        {
+            Pending_prof prof = {it->prof[n], grid->kcells, it->nmask, 1, 0};
+            pending_profs.push_back(prof);
+        }
+    }
+
+    // add the total fluxes that waited for the sums
+    std::vector<Pending_flux> fluxes;
+    fluxes.swap(pending_fluxes);
+    for (std::vector<Pending_flux>::const_iterator it=fluxes.begin(); it!=fluxes.end(); ++it)
+        add_fluxes(it->flux, it->turb, it->diff);
 }
@@ -177,6 +177,7 @@ void Thermo_buoy::calc_buoyancy_tend_2nd(double* restrict wt, double* restrict b
     const int jj = grid->icells;
     const int kk = grid->ijcells;
 
+    #pragma omp parallel for
     for (int k=grid->kstart+1; k<grid->kend; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
             #pragma ivdep
@@ -195,6 +196,7 @@ void Thermo_buoy::calc_buoyancy_tend_u_2nd(double* restrict ut, double* restrict
 
     const double sinalpha = std::sin(this->alpha);
     
+    #pragma omp parallel for
     for (int k=grid->kstart; k<grid->kend; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
             #pragma ivdep
@@ -212,6 +214,7 @@ void Thermo_buoy::calc_buoyancy_tend_w_2nd(double* restrict wt, double* restrict
 
     const double cosalpha = std::cos(this->alpha);
     
+    #pragma omp parallel for
     for (int k=grid->kstart+1; k<grid->kend; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
             #pragma ivdep
@@ -233,6 +236,7 @@ void Thermo_buoy::calc_buoyancy_tend_b_2nd(double* restrict bt, double* restrict
     const double n2 = this->n2;
     const double utrans = grid->utrans;
     
+    #pragma omp parallel for
     for (int k=grid->kstart; k<grid->kend; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
             #pragma ivdep
@@ -250,6 +254,7 @@ void Thermo_buoy::calc_buoyancy_tend_4th(double* restrict wt, double* restrict b
     const int kk1 = 1*grid->ijcells;
     const int kk2 = 2*grid->ijcells;
 
+    #pragma omp parallel for
     for (int k=grid->kstart+1; k<grid->kend; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
             #pragma ivdep
@@ -269,6 +274,7 @@ void Thermo_buoy::calc_buoyancy_tend_u_4th(double* restrict ut, double* restrict
 
     const double sinalpha = std::sin(this->alpha);
     
+    #pragma omp parallel for
     for (int k=grid->kstart; k<grid->kend; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
             #pragma ivdep
@@ -287,6 +293,7 @@ void Thermo_buoy::calc_buoyancy_tend_w_4th(double* restrict wt, double* restrict
 
     const double cosalpha = std::cos(this->alpha);
     
+    #pragma omp parallel for
     for (int k=grid->kstart+1; k<grid->kend; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
             #pragma ivdep
@@ -310,6 +317,7 @@ void Thermo_buoy::calc_buoyancy_tend_b_4th(double* restrict bt, double* restrict
     const double n2 = this->n2;
     const double utrans = grid->utrans;
     
+    #pragma omp parallel for
     for (int k=grid->kstart; k<grid->kend; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
             #pragma ivdep
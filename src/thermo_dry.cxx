@@ -169,7 +169,7 @@ unsigned long Thermo_dry::get_time_limit(unsigned long idt, const double dt)
     return Constants::ulhuge;
 }
 
-void Thermo_dry::exec_stats(Mask *m)
+void Thermo_dry::exec_stats()
 {
     const double NoOffset = 0.;
 
@@ -180,36 +180,22 @@ void Thermo_dry::exec_stats(Mask *m)
     // define the location
     const int sloc[] = {0,0,0};
 
-    // calculate the mean
-    stats->calc_mean(m->profs["b"].data, fields->atmp["tmp1"]->data, NoOffset, sloc,
-                     fields->atmp["tmp3"]->data, stats->nmask);
-
-    // calculate the moments
-    for (int n=2; n<5; ++n)
-    {
-        std::stringstream ss;
-        ss << n;
-        std::string sn = ss.str();
-        stats->calc_moment(fields->atmp["tmp1"]->data, m->profs["b"].data, m->profs["b"+sn].data, n, sloc,
-                           fields->atmp["tmp3"]->data, stats->nmask);
-    }
+    // calculate the mean and the moments
+    stats->calc_moments(stats->get_profs("b"), stats->get_profs("b2"), stats->get_profs("b3"), stats->get_profs("b4"),
+                        fields->atmp["tmp1"]->data, NoOffset, sloc);
 
     // calculate the gradients
     if (grid->swspatialorder == "2")
-        stats->calc_grad_2nd(fields->atmp["tmp1"]->data, m->profs["bgrad"].data, grid->dzhi, sloc,
-                             fields->atmp["tmp4"]->data, stats->nmaskh);
+        stats->calc_grad_2nd(fields->atmp["tmp1"]->data, stats->get_profs("bgrad"), grid->dzhi, sloc);
     else if (grid->swspatialorder == "4")
-        stats->calc_grad_4th(fields->atmp["tmp1"]->data, m->profs["bgrad"].data, grid->dzhi4, sloc,
-                             fields->atmp["tmp4"]->data, stats->nmaskh);
+        stats->calc_grad_4th(fields->atmp["tmp1"]->data, stats->get_profs("bgrad"), grid->dzhi4, sloc);
 
     // calculate turbulent fluxes
     if (grid->swspatialorder == "2")
-        stats->calc_flux_2nd(fields->atmp["tmp1"]->data, m->profs["b"].data, fields->w->data, m->profs["w"].data,
-                             m->profs["bw"].data, fields->atmp["tmp2"]->data, sloc,
-                             fields->atmp["tmp4"]->data, stats->nmaskh);
+        stats->calc_flux_2nd(fields->atmp["tmp1"]->data, stats->get_profs("b"), fields->w->data, stats->get_profs("w"),
+                             stats->get_profs("bw"), fields->atmp["tmp2"]->data, sloc);
     else if (grid->swspatialorder == "4")
-        stats->calc_flux_4th(fields->atmp["tmp1"]->data, fields->w->data, m->profs["bw"].data, fields->atmp["tmp2"]->data, sloc,
-                             fields->atmp["tmp4"]->data, stats->nmaskh);
+        stats->calc_flux_4th(fields->atmp["tmp1"]->data, fields->w->data, stats->get_profs("bw"), fields->atmp["tmp2"]->data, sloc);
 
     // calculate diffusive fluxes
     if (grid->swspatialorder == "2")
@@ -218,22 +204,19 @@ void Thermo_dry::exec_stats(Mask *m)
         {
             Diff_smag_2* diffptr = static_cast<Diff_smag_2*>(model->diff);
             stats->calc_diff_2nd(fields->atmp["tmp1"]->data, fields->w->data, fields->sd["evisc"]->data,
-                                 m->profs["bdiff"].data, grid->dzhi,
-                                 fields->atmp["tmp1"]->datafluxbot, fields->atmp["tmp1"]->datafluxtop, diffptr->tPr, sloc,
-                                 fields->atmp["tmp4"]->data, stats->nmaskh);
+                                 stats->get_profs("bdiff"), grid->dzhi,
+                                 fields->atmp["tmp1"]->datafluxbot, fields->atmp["tmp1"]->datafluxtop, diffptr->tPr, sloc);
         }
         else
-            stats->calc_diff_2nd(fields->atmp["tmp1"]->data, m->profs["bdiff"].data, grid->dzhi, fields->sp["th"]->visc, sloc,
-                                 fields->atmp["tmp4"]->data, stats->nmaskh);
+            stats->calc_diff_2nd(fields->atmp["tmp1"]->data, stats->get_profs("bdiff"), grid->dzhi, fields->sp["th"]->visc, sloc);
     }
     else if (grid->swspatialorder == "4")
     {
-        stats->calc_diff_4th(fields->atmp["tmp1"]->data, m->profs["bdiff"].data, grid->dzhi4, fields->sp["th"]->visc, sloc,
-                             fields->atmp["tmp4"]->data, stats->nmaskh);
+        stats->calc_diff_4th(fields->atmp["tmp1"]->data, stats->get_profs("bdiff"), grid->dzhi4, fields->sp["th"]->visc, sloc);
     }
 
     // calculate the total fluxes
-    stats->add_fluxes(m->profs["bflux"].data, m->profs["bw"].data, m->profs["bdiff"].data);
+    stats->add_fluxes(stats->get_profs("bflux"), stats->get_profs("bw"), stats->get_profs("bdiff"));
 
     // calculate the sorted buoyancy profile
     //stats->calc_sorted_prof(fields->sd["tmp1"]->data, fields->sd["tmp2"]->data, m->profs["bsort"].data);
@@ -350,6 +333,7 @@ void Thermo_dry::calc_buoyancy(double* restrict b, double* restrict th, double*
     const int jj = grid->icells;
     const int kk = grid->ijcells;
 
+#pragma omp parallel for
     for (int k=0; k<grid->kcells; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
 #pragma ivdep
@@ -365,6 +349,7 @@ void Thermo_dry::calc_N2(double* restrict N2, double* restrict th, double* restr
     const int jj = grid->icells;
     const int kk = grid->ijcells;
 
+#pragma omp parallel for
     for (int k=grid->kstart; k<grid->kend; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
 #pragma ivdep
@@ -415,6 +400,7 @@ void Thermo_dry::calc_buoyancy_tend_2nd(double* restrict wt, double* restrict th
     const int jj = grid->icells;
     const int kk = grid->ijcells;
 
+#pragma omp parallel for
     for (int k=grid->kstart+1; k<grid->kend; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
 #pragma ivdep
@@ -431,6 +417,7 @@ void Thermo_dry::calc_buoyancy_tend_4th(double* restrict wt, double* restrict th
     const int kk1 = 1*grid->ijcells;
     const int kk2 = 2*grid->ijcells;
 
+#pragma omp parallel for
     for (int k=grid->kstart+1; k<grid->kend; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
 #pragma ivdep
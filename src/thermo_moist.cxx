@@ -418,6 +418,7 @@ namespace mp
                            const int iend,   const int jend,   const int kend,
                            const int jj, const int kk)
     {
+        #pragma omp parallel for
         for (int k=kstart; k<kend; k++)
             for (int j=jstart; j<jend; j++)
                 #pragma ivdep
@@ -449,6 +450,7 @@ namespace mp
         const double nu_c   = 1;             // SB06, Table 1., same as UCLA-LES
         const double kccxs  = k_cc / (20. * x_star) * (nu_c+2)*(nu_c+4) / pow(nu_c+1, 2); 
 
+        #pragma omp parallel for
         for (int k=kstart; k<kend; k++)
             for (int j=jstart; j<jend; j++)
                 #pragma ivdep
@@ -484,6 +486,7 @@ namespace mp
     {
         const double lambda_evap = 1.; // 1.0 in UCLA, 0.7 in DALES
 
+        #pragma omp parallel for
         for (int k=kstart; k<kend; k++)
             for (int j=jstart; j<jend; j++)
                 #pragma ivdep
@@ -522,6 +525,7 @@ namespace mp
     {
         const double k_cr  = 5.25; // SB06, p49
 
+        #pragma omp parallel for
         for (int k=kstart; k<kend; k++)
             for (int j=jstart; j<jend; j++)
                 #pragma ivdep
@@ -554,6 +558,7 @@ namespace mp
         const double k_br1    = 1.0e3;  // SB06, p50, for 0.35e-3 <= Dr <= D_eq
         const double k_br2    = 2.3e3;  // SB06, p50, for Dr > D_eq
 
+        #pragma omp parallel for
         for (int k=kstart; k<kend; k++)
             for (int j=jstart; j<jend; j++)
                 #pragma ivdep
@@ -785,6 +790,7 @@ namespace mp
         const double b_R = a_R * exp(c_R*Dv); // UCLA-LES
 
         // Calculate sedimentation velocity at cell centre
+        #pragma omp parallel for
         for (int k=kstart; k<kend; k++)
             for (int j=jstart; j<jend; j++)
                 #pragma ivdep
@@ -810,6 +816,7 @@ namespace mp
 
         // Calculate maximum CFL based on interpolated velocity
         double cfl_max = 1e-5;
+        #pragma omp parallel for reduction(max:cfl_max)
         for (int k=kstart; k<kend; k++)
             for (int j=jstart; j<jend; j++)
                 #pragma ivdep
@@ -866,9 +873,12 @@ Thermo_moist::Thermo_moist(Model* modelin, Input* inputin) : Thermo(modelin, inp
         nerror += inputin->get_item(&swmicrobudget, "thermo", "swmicrobudget", "", "0");
         nerror += inputin->get_item(&cflmax_micro,  "thermo", "cflmax_micro",  "", 2.);
 
-        // The microphysics requires three additional tmp fields
-        const int n_tmp = 7;
-        fields->set_minimum_tmp_fields(n_tmp);
+        // The microphysics borrow the liquid water field and their xz slices at the same time
+        fields->set_minimum_tmp_fields_xz(1, n_micro_slices);
+
+        // The budget statistics of the microphysics use tmp5 to tmp7 next to the masks in tmp3 and tmp4
+        if (swmicrobudget == "1")
+            fields->set_minimum_tmp_fields(7);
 
         fields->init_prognostic_field("qr", "Rain water mixing ratio", "kg kg-1");
         fields->init_prognostic_field("nr", "Number density rain", "m-3");
@@ -968,6 +978,15 @@ void Thermo_moist::init()
 
     init_cross();
     init_dump();
+
+    // Borrow the scratch space of the microphysics once, such that a pool that is too small is found here
+    if (swmicro == "2mom_warm")
+    {
+        Tmp_fields tmp(fields);
+        double* ql;
+        double* slices[n_micro_slices];
+        get_micro_tmp(tmp, ql, slices);
+    }
 }
 
 void Thermo_moist::create(Input* inputin)
@@ -1026,27 +1045,30 @@ void Thermo_moist::exec()
     const int kk = grid->ijcells;
     const int kcells = grid->kcells;
 
-    // Re-calculate hydrostatic pressure and exner, pass dummy as rhoref,thvref to prevent overwriting base state
-    double *tmp2 = fields->atmp["tmp2"]->data;
-    if (swupdatebasestate)
-        calc_base_state(pref, prefh,
-                        &tmp2[0*kcells], &tmp2[1*kcells], &tmp2[2*kcells], &tmp2[3*kcells],
-                        exnref, exnrefh, fields->sp[thvar]->datamean, fields->sp["qt"]->datamean);
-
-    // extend later for gravity vector not normal to surface
-    if (grid->swspatialorder == "2")
+    // Scope of the scratch space, which is returned before the microphysics borrow theirs
     {
-        calc_buoyancy_tend_2nd(fields->wt->data, fields->sp[thvar]->data, fields->sp["qt"]->data, prefh,
-                               &fields->atmp["tmp2"]->data[0*kk], &fields->atmp["tmp2"]->data[1*kk],
-                               &fields->atmp["tmp2"]->data[2*kk], thvrefh);
+        Tmp_fields tmp(fields);
+
+        // Re-calculate hydrostatic pressure and exner, pass dummy as rhoref,thvref to prevent overwriting base state
+        if (swupdatebasestate)
+            calc_base_state(pref, prefh,
+                            tmp.get_slice(kcells), tmp.get_slice(kcells), tmp.get_slice(kcells), tmp.get_slice(kcells),
+                            exnref, exnrefh, fields->sp[thvar]->datamean, fields->sp["qt"]->datamean);
+
+        // extend later for gravity vector not normal to surface
+        if (grid->swspatialorder == "2")
+        {
+            calc_buoyancy_tend_2nd(fields->wt->data, fields->sp[thvar]->data, fields->sp["qt"]->data, prefh,
+                                   tmp.get_slice(kk), tmp.get_slice(kk), tmp.get_slice(kk), thvrefh);
+        }
+        //else if (grid->swspatialorder == "4")
+        //{
+        //    calc_buoyancy_tend_4th(fields->wt->data, fields->sp[thvar]->data, fields->sp["qt"]->data, prefh,
+        //                           &fields->atmp["tmp2"]->data[0*kk], &fields->atmp["tmp2"]->data[1*kk],
+        //                           &fields->atmp["tmp2"]->data[2*kk],
+        //                           thvrefh);
+        //}
     }
-    //else if (grid->swspatialorder == "4")
-    //{
-    //    calc_buoyancy_tend_4th(fields->wt->data, fields->sp[thvar]->data, fields->sp["qt"]->data, prefh,
-    //                           &fields->atmp["tmp2"]->data[0*kk], &fields->atmp["tmp2"]->data[1*kk],
-    //                           &fields->atmp["tmp2"]->data[2*kk],
-    //                           thvrefh);
-    //}
 
     // 2-moment warm microphysics 
     if(swmicro == "2mom_warm")
@@ -1058,7 +1080,8 @@ unsigned long Thermo_moist::get_time_limit(unsigned long idt, const double dt)
 {
     if(swmicro == "2mom_warm")
     {
-        double cfl = mp::calc_max_sedimentation_cfl(fields->atmp["tmp1"]->data, fields->sp["qr"]->data, fields->sp["nr"]->data,
+        Tmp_fields tmp(fields);
+        double cfl = mp::calc_max_sedimentation_cfl(tmp.get_field()->data, fields->sp["qr"]->data, fields->sp["nr"]->data,
                                                     fields->rhoref, grid->dzi, dt,
                                                     grid->istart, grid->jstart, grid->kstart,
                                                     grid->iend,   grid->jend,   grid->kend,
@@ -1082,36 +1105,40 @@ void Thermo_moist::exec_microphysics()
     mp::remove_neg_values(fields->sp["qr"]->data, grid->istart, grid->jstart, grid->kstart, grid->iend, grid->jend, grid->kend, grid->icells, grid->ijcells);
     mp::remove_neg_values(fields->sp["nr"]->data, grid->istart, grid->jstart, grid->kstart, grid->iend, grid->jend, grid->kend, grid->icells, grid->ijcells);
 
+    Tmp_fields tmp(fields);
+    double* ql;
+    double* slices[n_micro_slices];
+    get_micro_tmp(tmp, ql, slices);
+
     // Calculate the cloud liquid water concent using the saturation adjustment method
-    calc_liquid_water(fields->atmp["tmp1"]->data, fields->sp["thl"]->data, fields->sp["qt"]->data, pref);
+    calc_liquid_water(ql, fields->sp["thl"]->data, fields->sp["qt"]->data, pref);
 
     const double dt = model->timeloop->get_dt();
 
     // xz tmp slices for quantities which are used by multiple microphysics routines
-    const int ikslice = grid->icells * grid->kcells;
-    double* rain_mass = &fields->atmp["tmp2"]->data[0*ikslice]; 
-    double* rain_diam = &fields->atmp["tmp2"]->data[1*ikslice]; 
-    double* mu_r      = &fields->atmp["tmp2"]->data[2*ikslice]; 
-    double* lambda_r  = &fields->atmp["tmp3"]->data[0*ikslice]; 
+    double* rain_mass = slices[0];
+    double* rain_diam = slices[1];
+    double* mu_r      = slices[2];
+    double* lambda_r  = slices[3];
 
     // xz tmp slices for intermediate calculations
-    double* tmpxz1    = &fields->atmp["tmp3"]->data[1*ikslice];
-    double* tmpxz2    = &fields->atmp["tmp3"]->data[2*ikslice];
-    double* tmpxz3    = &fields->atmp["tmp4"]->data[0*ikslice];
-    double* tmpxz4    = &fields->atmp["tmp4"]->data[1*ikslice];
-    double* tmpxz5    = &fields->atmp["tmp4"]->data[2*ikslice];
-    double* tmpxz6    = &fields->atmp["tmp5"]->data[0*ikslice];
+    double* tmpxz1    = slices[4];
+    double* tmpxz2    = slices[5];
+    double* tmpxz3    = slices[6];
+    double* tmpxz4    = slices[7];
+    double* tmpxz5    = slices[8];
+    double* tmpxz6    = slices[9];
 
     // Autoconversion; formation of rain drop by coagulating cloud droplets
     mp::autoconversion(fields->st["qr"]->data, fields->st["nr"]->data, fields->st["qt"]->data, fields->st["thl"]->data,
-                       fields->sp["qr"]->data, fields->atmp["tmp1"]->data, fields->rhoref, exnref,
+                       fields->sp["qr"]->data, ql, fields->rhoref, exnref,
                        grid->istart, grid->jstart, grid->kstart, 
                        grid->iend,   grid->jend,   grid->kend, 
                        grid->icells, grid->ijcells);
 
     // Accretion; growth of raindrops collecting cloud droplets
     mp::accretion(fields->st["qr"]->data, fields->st["qt"]->data, fields->st["thl"]->data,
-                  fields->sp["qr"]->data, fields->atmp["tmp1"]->data, fields->rhoref, exnref,
+                  fields->sp["qr"]->data, ql, fields->rhoref, exnref,
                   grid->istart, grid->jstart, grid->kstart, 
                   grid->iend,   grid->jend,   grid->kend, 
                   grid->icells, grid->ijcells);
@@ -1125,7 +1152,7 @@ void Thermo_moist::exec_microphysics()
 
             // Evaporation; evaporation of rain drops in unsaturated environment
             mp2d::evaporation(fields->st["qr"]->data, fields->st["nr"]->data,  fields->st["qt"]->data, fields->st["thl"]->data,
-                              fields->sp["qr"]->data, fields->sp["nr"]->data,  fields->atmp["tmp1"]->data,
+                              fields->sp["qr"]->data, fields->sp["nr"]->data,  ql,
                               fields->sp["qt"]->data, fields->sp["thl"]->data, fields->rhoref, exnref, pref,
                               rain_mass, rain_diam,
                               grid->istart, grid->jstart, grid->kstart, 
@@ -1153,7 +1180,7 @@ void Thermo_moist::exec_microphysics()
     {
         // Evaporation; evaporation of rain drops in unsaturated environment
         mp::evaporation(fields->st["qr"]->data, fields->st["nr"]->data,  fields->st["qt"]->data, fields->st["thl"]->data,
-                        fields->sp["qr"]->data, fields->sp["nr"]->data,  fields->atmp["tmp1"]->data,
+                        fields->sp["qr"]->data, fields->sp["nr"]->data,  ql,
                         fields->sp["qt"]->data, fields->sp["thl"]->data, fields->rhoref, exnref, pref,
                         grid->istart, grid->jstart, grid->kstart, 
                         grid->iend,   grid->jend,   grid->kend, 
@@ -1167,7 +1194,7 @@ void Thermo_moist::exec_microphysics()
     
         // Sedimentation; sub-grid sedimentation of rain 
         mp::sedimentation_ss08(fields->st["qr"]->data, fields->st["nr"]->data, 
-                               fields->atmp["tmp4"]->data, fields->atmp["tmp5"]->data,
+                               tmp.get_field()->data, tmp.get_field()->data,
                                fields->sp["qr"]->data, fields->sp["nr"]->data, 
                                fields->rhoref, grid->dzi, grid->dz, dt,
                                grid->istart, grid->jstart, grid->kstart, 
@@ -1176,6 +1203,19 @@ void Thermo_moist::exec_microphysics()
     }
 }
 
+/**
+ * This function borrows the scratch space of the microphysics: the liquid water field and
+ * n_micro_slices slices of the size of an xz plane, as declared with set_minimum_tmp_fields_xz.
+ */
+void Thermo_moist::get_micro_tmp(Tmp_fields& tmp, double*& ql, double** slices)
+{
+    ql = tmp.get_field()->data;
+
+    const int ikslice = grid->icells * grid->kcells;
+    for (int n=0; n<n_micro_slices; ++n)
+        slices[n] = tmp.get_slice(ikslice);
+}
+
 void Thermo_moist::get_mask(Field3d *mfield, Field3d *mfieldh, Mask *m)
 {
     if (m->name == "ql")
@@ -1314,7 +1354,7 @@ void Thermo_moist::calc_mask_qlcore(double* restrict mask, double* restrict mask
     *nmaskbot = nmaskh[grid->kstart];
 }
 
-void Thermo_moist::exec_stats(Mask *m)
+void Thermo_moist::exec_stats()
 {
     const double NoOffset = 0.;
 
@@ -1325,36 +1365,22 @@ void Thermo_moist::exec_stats(Mask *m)
     // define location
     const int sloc[] = {0,0,0};
 
-    // mean
-    stats->calc_mean(m->profs["b"].data, fields->atmp["tmp1"]->data, NoOffset, sloc,
-                     fields->atmp["tmp3"]->data, stats->nmask);
-
-    // moments
-    for (int n=2; n<5; ++n)
-    {
-        std::stringstream ss;
-        ss << n;
-        std::string sn = ss.str();
-        stats->calc_moment(fields->atmp["tmp1"]->data, m->profs["b"].data, m->profs["b"+sn].data, n, sloc,
-                           fields->atmp["tmp3"]->data, stats->nmask);
-    }
+    // calculate the mean and the moments
+    stats->calc_moments(stats->get_profs("b"), stats->get_profs("b2"), stats->get_profs("b3"), stats->get_profs("b4"),
+                        fields->atmp["tmp1"]->data, NoOffset, sloc);
 
     // calculate the gradients
     if (grid->swspatialorder == "2")
-        stats->calc_grad_2nd(fields->atmp["tmp1"]->data, m->profs["bgrad"].data, grid->dzhi, sloc,
-                             fields->atmp["tmp4"]->data, stats->nmaskh);
+        stats->calc_grad_2nd(fields->atmp["tmp1"]->data, stats->get_profs("bgrad"), grid->dzhi, sloc);
     else if (grid->swspatialorder == "4")
-        stats->calc_grad_4th(fields->atmp["tmp1"]->data, m->profs["bgrad"].data, grid->dzhi4, sloc,
-                             fields->atmp["tmp4"]->data, stats->nmaskh);
+        stats->calc_grad_4th(fields->atmp["tmp1"]->data, stats->get_profs("bgrad"), grid->dzhi4, sloc);
 
     // calculate turbulent fluxes
     if (grid->swspatialorder == "2")
-        stats->calc_flux_2nd(fields->atmp["tmp1"]->data, m->profs["b"].data, fields->w->data, m->profs["w"].data,
-                             m->profs["bw"].data, fields->atmp["tmp2"]->data, sloc,
-                             fields->atmp["tmp4"]->data, stats->nmaskh);
+        stats->calc_flux_2nd(fields->atmp["tmp1"]->data, stats->get_profs("b"), fields->w->data, stats->get_profs("w"),
+                             stats->get_profs("bw"), fields->atmp["tmp2"]->data, sloc);
     else if (grid->swspatialorder == "4")
-        stats->calc_flux_4th(fields->atmp["tmp1"]->data, fields->w->data, m->profs["bw"].data, fields->atmp["tmp2"]->data, sloc,
-                             fields->atmp["tmp4"]->data, stats->nmaskh);
+        stats->calc_flux_4th(fields->atmp["tmp1"]->data, fields->w->data, stats->get_profs("bw"), fields->atmp["tmp2"]->data, sloc);
 
     // calculate diffusive fluxes
     if (grid->swspatialorder == "2")
@@ -1363,39 +1389,35 @@ void Thermo_moist::exec_stats(Mask *m)
         {
             Diff_smag_2 *diffptr = static_cast<Diff_smag_2 *>(model->diff);
             stats->calc_diff_2nd(fields->atmp["tmp1"]->data, fields->w->data, fields->sd["evisc"]->data,
-                                 m->profs["bdiff"].data, grid->dzhi,
-                                 fields->atmp["tmp1"]->datafluxbot, fields->atmp["tmp1"]->datafluxtop, diffptr->tPr, sloc,
-                                 fields->atmp["tmp4"]->data, stats->nmaskh);
+                                 stats->get_profs("bdiff"), grid->dzhi,
+                                 fields->atmp["tmp1"]->datafluxbot, fields->atmp["tmp1"]->datafluxtop, diffptr->tPr, sloc);
         }
         else
         {
-            stats->calc_diff_2nd(fields->atmp["tmp1"]->data, m->profs["bdiff"].data, grid->dzhi, fields->sp[thvar]->visc, sloc,
-                                 fields->atmp["tmp4"]->data, stats->nmaskh);
+            stats->calc_diff_2nd(fields->atmp["tmp1"]->data, stats->get_profs("bdiff"), grid->dzhi, fields->sp[thvar]->visc, sloc);
         }
     }
     else if (grid->swspatialorder == "4")
     {
         // take the diffusivity of temperature for that of buoyancy
-        stats->calc_diff_4th(fields->atmp["tmp1"]->data, m->profs["bdiff"].data, grid->dzhi4, fields->sp[thvar]->visc, sloc,
-                             fields->atmp["tmp4"]->data, stats->nmaskh);
+        stats->calc_diff_4th(fields->atmp["tmp1"]->data, stats->get_profs("bdiff"), grid->dzhi4, fields->sp[thvar]->visc, sloc);
     }
 
     // calculate the total fluxes
-    stats->add_fluxes(m->profs["bflux"].data, m->profs["bw"].data, m->profs["bdiff"].data);
+    stats->add_fluxes(stats->get_profs("bflux"), stats->get_profs("bw"), stats->get_profs("bdiff"));
 
     // calculate the liquid water stats
     calc_liquid_water(fields->atmp["tmp1"]->data, fields->sp[thvar]->data, fields->sp["qt"]->data, pref);
-    stats->calc_mean(m->profs["ql"].data, fields->atmp["tmp1"]->data, NoOffset, sloc, fields->atmp["tmp3"]->data, stats->nmask);
-    stats->calc_count(fields->atmp["tmp1"]->data, m->profs["cfrac"].data, 0.,
-                      fields->atmp["tmp3"]->data, stats->nmask);
+    stats->calc_mean(stats->get_profs("ql"), fields->atmp["tmp1"]->data, NoOffset, sloc);
+    stats->calc_count(fields->atmp["tmp1"]->data, stats->get_profs("cfrac"), 0.);
 
-    stats->calc_cover(fields->atmp["tmp1"]->data, fields->atmp["tmp4"]->databot, &stats->nmaskbot, &m->tseries["ccover"].data, 0.);
-    stats->calc_path (fields->atmp["tmp1"]->data, fields->atmp["tmp4"]->databot, &stats->nmaskbot, &m->tseries["lwp"].data);
+    stats->calc_cover(fields->atmp["tmp1"]->data, stats->get_time_series("ccover"), 0.);
+    stats->calc_path (fields->atmp["tmp1"]->data, stats->get_time_series("lwp"));
 
     // BvS:micro 
     if(swmicro == "2mom_warm")
     {
-        stats->calc_path (fields->sp["qr"]->data, fields->atmp["tmp4"]->databot, &stats->nmaskbot, &m->tseries["rwp"].data);
+        stats->calc_path (fields->sp["qr"]->data, stats->get_time_series("rwp"));
 
         if(swmicrobudget == "1")
         {
@@ -1411,10 +1433,10 @@ void Thermo_moist::exec_stats(Mask *m)
                                grid->iend,   grid->jend,   grid->kend, 
                                grid->icells, grid->ijcells);
 
-            stats->calc_mean(m->profs["auto_qrt" ].data, fields->atmp["tmp2"]->data, NoOffset, sloc, fields->atmp["tmp3"]->data, stats->nmask);
-            stats->calc_mean(m->profs["auto_nrt" ].data, fields->atmp["tmp5"]->data, NoOffset, sloc, fields->atmp["tmp3"]->data, stats->nmask);
-            stats->calc_mean(m->profs["auto_qtt" ].data, fields->atmp["tmp6"]->data, NoOffset, sloc, fields->atmp["tmp3"]->data, stats->nmask);
-            stats->calc_mean(m->profs["auto_thlt"].data, fields->atmp["tmp7"]->data, NoOffset, sloc, fields->atmp["tmp3"]->data, stats->nmask);
+            stats->calc_mean(stats->get_profs("auto_qrt" ), fields->atmp["tmp2"]->data, NoOffset, sloc);
+            stats->calc_mean(stats->get_profs("auto_nrt" ), fields->atmp["tmp5"]->data, NoOffset, sloc);
+            stats->calc_mean(stats->get_profs("auto_qtt" ), fields->atmp["tmp6"]->data, NoOffset, sloc);
+            stats->calc_mean(stats->get_profs("auto_thlt"), fields->atmp["tmp7"]->data, NoOffset, sloc);
 
             // Evaporation
             mp::zero(fields->atmp["tmp2"]->data, grid->ncells);
@@ -1429,10 +1451,10 @@ void Thermo_moist::exec_stats(Mask *m)
                             grid->iend,   grid->jend,   grid->kend, 
                             grid->icells, grid->ijcells);
 
-            stats->calc_mean(m->profs["evap_qrt" ].data, fields->atmp["tmp2"]->data, NoOffset, sloc, fields->atmp["tmp3"]->data, stats->nmask);
-            stats->calc_mean(m->profs["evap_nrt" ].data, fields->atmp["tmp5"]->data, NoOffset, sloc, fields->atmp["tmp3"]->data, stats->nmask);
-            stats->calc_mean(m->profs["evap_qtt" ].data, fields->atmp["tmp6"]->data, NoOffset, sloc, fields->atmp["tmp3"]->data, stats->nmask);
-            stats->calc_mean(m->profs["evap_thlt"].data, fields->atmp["tmp7"]->data, NoOffset, sloc, fields->atmp["tmp3"]->data, stats->nmask);
+            stats->calc_mean(stats->get_profs("evap_qrt" ), fields->atmp["tmp2"]->data, NoOffset, sloc);
+            stats->calc_mean(stats->get_profs("evap_nrt" ), fields->atmp["tmp5"]->data, NoOffset, sloc);
+            stats->calc_mean(stats->get_profs("evap_qtt" ), fields->atmp["tmp6"]->data, NoOffset, sloc);
+            stats->calc_mean(stats->get_profs("evap_thlt"), fields->atmp["tmp7"]->data, NoOffset, sloc);
 
             // Accretion
             mp::zero(fields->atmp["tmp2"]->data, grid->ncells);
@@ -1445,9 +1467,9 @@ void Thermo_moist::exec_stats(Mask *m)
                           grid->iend,   grid->jend,   grid->kend, 
                           grid->icells, grid->ijcells);
 
-            stats->calc_mean(m->profs["accr_qrt" ].data, fields->atmp["tmp2"]->data, NoOffset, sloc, fields->atmp["tmp3"]->data, stats->nmask);
-            stats->calc_mean(m->profs["accr_qtt" ].data, fields->atmp["tmp5"]->data, NoOffset, sloc, fields->atmp["tmp3"]->data, stats->nmask);
-            stats->calc_mean(m->profs["accr_thlt"].data, fields->atmp["tmp6"]->data, NoOffset, sloc, fields->atmp["tmp3"]->data, stats->nmask);
+            stats->calc_mean(stats->get_profs("accr_qrt" ), fields->atmp["tmp2"]->data, NoOffset, sloc);
+            stats->calc_mean(stats->get_profs("accr_qtt" ), fields->atmp["tmp5"]->data, NoOffset, sloc);
+            stats->calc_mean(stats->get_profs("accr_thlt"), fields->atmp["tmp6"]->data, NoOffset, sloc);
 
             // Selfcollection and breakup
             mp::zero(fields->atmp["tmp2"]->data, grid->ncells);
@@ -1457,7 +1479,7 @@ void Thermo_moist::exec_stats(Mask *m)
                                        grid->iend,   grid->jend,   grid->kend, 
                                        grid->icells, grid->ijcells);
 
-            stats->calc_mean(m->profs["scbr_nrt" ].data, fields->atmp["tmp2"]->data, NoOffset, sloc, fields->atmp["tmp3"]->data, stats->nmask);
+            stats->calc_mean(stats->get_profs("scbr_nrt" ), fields->atmp["tmp2"]->data, NoOffset, sloc);
 
             // Sedimentation
             mp::zero(fields->atmp["tmp2"]->data, grid->ncells);
@@ -1498,8 +1520,8 @@ void Thermo_moist::exec_stats(Mask *m)
                                    grid->iend,   grid->jend,   grid->kend, 
                                    grid->icells, grid->kcells, grid->ijcells);
 
-            stats->calc_mean(m->profs["sed_qrt"].data, fields->atmp["tmp2"]->data, NoOffset, sloc, fields->atmp["tmp3"]->data, stats->nmask);
-            stats->calc_mean(m->profs["sed_nrt"].data, fields->atmp["tmp5"]->data, NoOffset, sloc, fields->atmp["tmp3"]->data, stats->nmask);
+            stats->calc_mean(stats->get_profs("sed_qrt"), fields->atmp["tmp2"]->data, NoOffset, sloc);
+            stats->calc_mean(stats->get_profs("sed_nrt"), fields->atmp["tmp5"]->data, NoOffset, sloc);
         }
     }
 
@@ -1512,13 +1534,19 @@ void Thermo_moist::exec_stats(Mask *m)
                         &tmp2[4*kcells], &tmp2[5*kcells], &tmp2[6*kcells], &tmp2[7*kcells],
                         fields->sp[thvar]->datamean, fields->sp["qt"]->datamean);
 
-        for (int k=0; k<kcells; ++k)
-        {
-            m->profs["ph"  ].data[k] = tmp2[0*kcells+k];
-            m->profs["phh" ].data[k] = tmp2[1*kcells+k];
-            m->profs["rho" ].data[k] = tmp2[2*kcells+k];
-            m->profs["rhoh"].data[k] = tmp2[3*kcells+k];
-        }
+        const Mask_data ph   = stats->get_profs("ph"  );
+        const Mask_data phh  = stats->get_profs("phh" );
+        const Mask_data rho  = stats->get_profs("rho" );
+        const Mask_data rhoh = stats->get_profs("rhoh");
+
+        for (int n=0; n<stats->get_nmasks(); ++n)
+            for (int k=0; k<kcells; ++k)
+            {
+                ph  [n][k] = tmp2[0*kcells+k];
+                phh [n][k] = tmp2[1*kcells+k];
+                rho [n][k] = tmp2[2*kcells+k];
+                rhoh[n][k] = tmp2[3*kcells+k];
+            }
     }
 }
 
@@ -1626,8 +1654,8 @@ void Thermo_moist::get_thermo_field(Field3d* fld, Field3d* tmp, const std::strin
     const int kcells = grid->kcells;
 
     // BvS: getThermoField() is called from subgrid-model, before thermo(), so re-calculate the hydrostatic pressure
-    // Pass dummy as rhoref,thvref to prevent overwriting base state
-    double* restrict tmp2 = fields->atmp["tmp2"]->data;
+    // Pass dummy as rhoref,thvref to prevent overwriting base state, tmp is overwritten afterwards
+    double* restrict tmp2 = tmp->data;
     if (swupdatebasestate)
         calc_base_state(pref, prefh, &tmp2[0*kcells], &tmp2[1*kcells], &tmp2[2*kcells], &tmp2[3*kcells], exnref, exnrefh,
                 fields->sp[thvar]->datamean, fields->sp["qt"]->datamean);
@@ -1782,11 +1810,11 @@ void Thermo_moist::calc_buoyancy_tend_2nd(double* restrict wt, double* restrict
     const int jj = grid->icells;
     const int kk = grid->ijcells;
 
-    double tl, exnh;
-
+    #pragma omp parallel
     for (int k=grid->kstart+1; k<grid->kend; k++)
     {
-        exnh = exner(ph[k]);
+        const double exnh = exner(ph[k]);
+        #pragma omp for
         for (int j=grid->jstart; j<grid->jend; j++)
             #pragma ivdep
             for (int i=grid->istart; i<grid->iend; i++)
@@ -1795,11 +1823,12 @@ void Thermo_moist::calc_buoyancy_tend_2nd(double* restrict wt, double* restrict
                 const int ij  = i + j*jj;
                 thlh[ij] = interp2(thl[ijk-kk], thl[ijk]);
                 qth[ij]  = interp2(qt[ijk-kk], qt[ijk]);
-                tl       = thlh[ij] * exnh;
+                const double tl = thlh[ij] * exnh;
                 // Calculate first estimate of ql using Tl
                 // if ql(Tl)>0, saturation adjustment routine needed
                 ql[ij]  = qth[ij]-qsat(ph[k],tl);
             }
+        #pragma omp for
         for (int j=grid->jstart; j<grid->jend; j++)
             #pragma ivdep
             for (int i=grid->istart; i<grid->iend; i++)
@@ -1812,6 +1841,7 @@ void Thermo_moist::calc_buoyancy_tend_2nd(double* restrict wt, double* restrict
                 else
                     ql[ij] = 0.;
             }
+        #pragma omp for
         for (int j=grid->jstart; j<grid->jend; j++)
             #pragma ivdep
             for (int i=grid->istart; i<grid->iend; i++)
@@ -1830,21 +1860,22 @@ void Thermo_moist::calc_buoyancy(double* restrict b, double* restrict thl, doubl
     const int jj = grid->icells;
     const int kk = grid->ijcells;
 
-    double tl, ex;
-
+    #pragma omp parallel
     for (int k=0; k<grid->kcells; k++)
     {
-        ex = exner(p[k]);
+        const double ex = exner(p[k]);
+        #pragma omp for
         for (int j=grid->jstart; j<grid->jend; j++)
             #pragma ivdep
             for (int i=grid->istart; i<grid->iend; i++)
             {
                 const int ijk = i + j*jj + k*kk;
                 const int ij  = i + j*jj;
-                tl  = thl[ijk] * ex;
+                const double tl = thl[ijk] * ex;
                 ql[ij]  = qt[ijk]-qsat(p[k],tl);   // not real ql, just estimate
             }
 
+        #pragma omp for
         for (int j=grid->jstart; j<grid->jend; j++)
             #pragma ivdep
             for (int i=grid->istart; i<grid->iend; i++)
@@ -1857,6 +1888,7 @@ void Thermo_moist::calc_buoyancy(double* restrict b, double* restrict thl, doubl
                     ql[ij] = 0.;
             }
 
+        #pragma omp for
         for (int j=grid->jstart; j<grid->jend; j++)
             #pragma ivdep
             for (int i=grid->istart; i<grid->iend; i++)
@@ -1924,8 +1956,6 @@ void Thermo_moist::calc_maximum_thv_perturbation_cloud(double* restrict thv_pert
 
 void Thermo_moist::calc_liquid_water(double* restrict ql, double* restrict thl, double* restrict qt, double* restrict p)
 {
-    double ex;
-
     const int jj = grid->icells;
     const int kk = grid->ijcells;
 
@@ -1953,9 +1983,10 @@ void Thermo_moist::calc_liquid_water(double* restrict ql, double* restrict thl,
     }
 
     // Calculate the ql field
+    #pragma omp parallel for
     for (int k=grid->kstart; k<grid->kend; k++)
     {
-        ex = exner(p[k]);
+        const double ex = exner(p[k]);
         for (int j=grid->jstart; j<grid->jend; j++)
             #pragma ivdep
             for (int i=grid->istart; i<grid->iend; i++)
@@ -1972,6 +2003,7 @@ void Thermo_moist::calc_N2(double* restrict N2, double* restrict thl, double* re
     const int jj = grid->icells;
     const int kk = grid->ijcells;
 
+    #pragma omp parallel for
     for (int k=grid->kstart; k<grid->kend; ++k)
         for (int j=grid->jstart; j<grid->jend; ++j)
             #pragma ivdep
@@ -2166,11 +2198,11 @@ void Thermo_moist::calc_buoyancy_tend_4th(double* restrict wt, double* restrict
     const int kk1 = 1*grid->ijcells;
     const int kk2 = 2*grid->ijcells;
 
-    double tl, exnh;
-
+    #pragma omp parallel
     for (int k=grid->kstart+1; k<grid->kend; k++)
     {
-        exnh = exner(ph[k]);
+        const double exnh = exner(ph[k]);
+        #pragma omp for
         for (int j=grid->jstart; j<grid->jend; j++)
             #pragma ivdep
             for (int i=grid->istart; i<grid->iend; i++)
@@ -2179,11 +2211,12 @@ void Thermo_moist::calc_buoyancy_tend_4th(double* restrict wt, double* restrict
                 const int ij  = i + j*jj;
                 thlh[ij] = interp4(thl[ijk-kk2], thl[ijk-kk1], thl[ijk], thl[ijk+kk1]);
                 qth[ij]  = interp4(qt[ijk-kk2],  qt[ijk-kk1],  qt[ijk],  qt[ijk+kk1]);
-                tl       = thlh[ij] * exnh;
+                const double tl = thlh[ij] * exnh;
                 // Calculate first estimate of ql using Tl
                 // if ql(Tl)>0, saturation adjustment routine needed
                 ql[ij]  = qth[ij]-qsat(ph[k],tl);
             }
+        #pragma omp for
         for (int j=grid->jstart; j<grid->jend; j++)
             #pragma ivdep
             for (int i=grid->istart; i<grid->iend; i++)
@@ -2194,6 +2227,7 @@ void Thermo_moist::calc_buoyancy_tend_4th(double* restrict wt, double* restrict
                 else
                     ql[ij] = 0.;
             }
+        #pragma omp for
         for (int j=grid->jstart; j<grid->jend; j++)
             #pragma ivdep
             for (int i=grid->istart; i<grid->iend; i++)
@@ -22,6 +22,7 @@
 
 #include <cstdio>
 #include <cmath>
+#include <vector>
 #include "input.h"
 #include "master.h"
 #include "grid.h"
@@ -31,6 +32,27 @@
 #include "constants.h"
 #include "model.h"
 
+namespace
+{
+    // Coefficients of the low-storage Runge-Kutta schemes.
+    const double rk3cA [] = {0., -5./9., -153./128.};
+    const double rk3cB [] = {1./3., 15./16., 8./15.};
+
+    const double rk4cA [] = {
+        0.,
+        - 567301805773./1357537059087.,
+        -2404267990393./2016746695238.,
+        -3550918686646./2091501179385.,
+        -1275806237668./ 842570457699.};
+
+    const double rk4cB [] = {
+        1432997174477./ 9575080441755.,
+        5161836677717./13612068292357.,
+        1720146321549./ 2090206949498.,
+        3134564353537./ 4481467310338.,
+        2277821191437./14882151754819.};
+}
+
 Timeloop::Timeloop(Model* modelin, Input* inputin)
 {
     model  = modelin;
@@ -60,6 +82,7 @@ Timeloop::Timeloop(Model* modelin, Input* inputin)
     n += inputin->get_item(&rkorder     , "time", "rkorder"     , "", 3               );
     n += inputin->get_item(&outputiter  , "time", "outputiter"  , "", 20              );
     n += inputin->get_item(&iotimeprec  , "time", "iotimeprec"  , "", 0               );
+    n += inputin->get_item(&rkallfields , "time", "rkallfields" , "", false           );
 
     if (master->mode == "post")
         n += inputin->get_item(&postproctime, "time", "postproctime", "");
@@ -218,16 +241,22 @@ void Timeloop::exec()
 {
     if (rkorder == 3)
     {
-        for (FieldMap::const_iterator it = fields->at.begin(); it!=fields->at.end(); ++it)
-            rk3(fields->ap[it->first]->data, it->second->data, dt);
+        if (rkallfields)
+            rk_all(rk3cB[substep], rk3cA[(substep+1) % 3], dt);
+        else
+            for (FieldMap::const_iterator it = fields->at.begin(); it!=fields->at.end(); ++it)
+                rk3(fields->ap[it->first]->data, it->second->data, dt);
 
         substep = (substep+1) % 3;
     }
 
     if (rkorder == 4)
     {
-        for (FieldMap::const_iterator it = fields->at.begin(); it!=fields->at.end(); ++it)
-            rk4(fields->ap[it->first]->data, it->second->data, dt);
+        if (rkallfields)
+            rk_all(rk4cB[substep], rk4cA[(substep+1) % 5], dt);
+        else
+            for (FieldMap::const_iterator it = fields->at.begin(); it!=fields->at.end(); ++it)
+                rk4(fields->ap[it->first]->data, it->second->data, dt);
 
         substep = (substep+1) % 5;
     }
@@ -247,90 +276,89 @@ double Timeloop::get_sub_time_step()
 
 inline double Timeloop::rk3subdt(const double dt)
 {
-    const double cB [] = {1./3., 15./16., 8./15.};
-    return cB[substep]*dt;
+    return rk3cB[substep]*dt;
 }
 
 inline double Timeloop::rk4subdt(const double dt)
 {
-    const double cB [] = {
-        1432997174477./ 9575080441755.,
-        5161836677717./13612068292357.,
-        1720146321549./ 2090206949498.,
-        3134564353537./ 4481467310338.,
-        2277821191437./14882151754819.};
-    return cB[substep]*dt;
+    return rk4cB[substep]*dt;
 }
 
+// The state is updated and the tendency is rescaled for the next substep in a single sweep.
+// Substep 0 resets the tendencies, because cA[0] == 0.
 void Timeloop::rk3(double * restrict a, double * restrict at, const double dt)
 {
-    const double cA [] = {0., -5./9., -153./128.};
-    const double cB [] = {1./3., 15./16., 8./15.};
+    const double cBdt = rk3cB[substep]*dt;
+    const double cAn  = rk3cA[(substep+1) % 3];
 
     const int jj = grid->icells;
     const int kk = grid->ijcells;
 
+#pragma omp parallel for
     for (int k=grid->kstart; k<grid->kend; k++)
         for (int j=grid->jstart; j<grid->jend; j++)
 #pragma ivdep
             for (int i=grid->istart; i<grid->iend; i++)
             {
                 const int ijk = i + j*jj + k*kk;
-                a[ijk] += cB[substep]*dt*at[ijk];
-            }
-
-    const int substepn = (substep+1) % 3;
-
-    // substep 0 resets the tendencies, because cA[0] == 0
-    for (int k=grid->kstart; k<grid->kend; k++)
-        for (int j=grid->jstart; j<grid->jend; j++)
-#pragma ivdep
-            for (int i=grid->istart; i<grid->iend; i++)
-            {
-                const int ijk = i + j*jj + k*kk;
-                at[ijk] *= cA[substepn];
+                a [ijk] += cBdt*at[ijk];
+                at[ijk] *= cAn;
             }
 }
 
 void Timeloop::rk4(double * restrict a, double * restrict at, const double dt)
 {
-    const double cA [] = {
-        0.,
-        - 567301805773./1357537059087.,
-        -2404267990393./2016746695238.,
-        -3550918686646./2091501179385.,
-        -1275806237668./ 842570457699.};
-
-    const double cB [] = {
-        1432997174477./ 9575080441755.,
-        5161836677717./13612068292357.,
-        1720146321549./ 2090206949498.,
-        3134564353537./ 4481467310338.,
-        2277821191437./14882151754819.};
+    const double cBdt = rk4cB[substep]*dt;
+    const double cAn  = rk4cA[(substep+1) % 5];
 
     const int jj = grid->icells;
     const int kk = grid->ijcells;
 
+#pragma omp parallel for
     for (int k=grid->kstart; k<grid->kend; k++)
         for (int j=grid->jstart; j<grid->jend; j++)
 #pragma ivdep
             for (int i=grid->istart; i<grid->iend; i++)
             {
                 const int ijk = i + j*jj + k*kk;
-                a[ijk] = a[ijk] + cB[substep]*dt*at[ijk];
+                a [ijk] = a[ijk] + cBdt*at[ijk];
+                at[ijk] = cAn*at[ijk];
             }
+}
 
-    const int substepn = (substep+1) % 5;
+// Update all prognostic fields in one threaded loop nest, such that the threads are
+// started once per substep rather than once per field.
+void Timeloop::rk_all(const double cB, const double cA, const double dt)
+{
+    std::vector<double*> a;
+    std::vector<double*> at;
+    for (FieldMap::const_iterator it = fields->at.begin(); it!=fields->at.end(); ++it)
+    {
+        a .push_back(fields->ap[it->first]->data);
+        at.push_back(it->second->data);
+    }
+
+    const int nfields = a.size();
+    const double cBdt = cB*dt;
+
+    const int jj = grid->icells;
+    const int kk = grid->ijcells;
 
-    // substep 0 resets the tendencies, because cA[0] == 0
+#pragma omp parallel for
     for (int k=grid->kstart; k<grid->kend; k++)
-        for (int j=grid->jstart; j<grid->jend; j++)
+        for (int n=0; n<nfields; n++)
+        {
+            double* restrict an  = a [n];
+            double* restrict atn = at[n];
+            for (int j=grid->jstart; j<grid->jend; j++)
 #pragma ivdep
-            for (int i=grid->istart; i<grid->iend; i++)
-            {
-                const int ijk = i + j*jj + k*kk;
-                at[ijk] = cA[substepn]*at[ijk];
-            }
+                for (int i=grid->istart; i<grid->iend; i++)
+                {
+                    const int ijk = i + j*jj + k*kk;
+                    an [ijk] += cBdt*atn[ijk];
+                    atn[ijk] *= cA;
+                }
+        }
 }
 
 bool Timeloop::in_substep()
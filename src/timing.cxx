@@ -0,0 +1,244 @@
+/*
+ * MicroHH
+ * Copyright (c) 2011-2017 Chiel van Heerwaarden
+ * Copyright (c) 2011-2017 Thijs Heus
+ * Copyright (c) 2014-2017 Bart van Stratum
+ *
+ * This file is part of MicroHH
+ *
+ * MicroHH is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * MicroHH is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with MicroHH.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "master.h"
+#include "input.h"
+#include "model.h"
+#include "timing.h"
+
+#ifdef USECUDA
+#include <cuda_runtime_api.h>
+#endif
+
+Timing::Timing(Model* modelin, Input* inputin)
+{
+    model  = modelin;
+    master = model->master;
+
+    timingfile = 0;
+    tracefile  = 0;
+
+    timing_open = false;
+
+    int nerror = 0;
+    nerror += inputin->get_item(&swtiming, "timing", "swtiming", "", "0");
+    nerror += inputin->get_item(&swtrace , "timing", "swtrace" , "", "0");
+
+    if (nerror)
+        throw 1;
+
+    if (swtiming != "0" && swtiming != "1")
+    {
+        master->print_error("\"%s\" is an illegal value for swtiming\n", swtiming.c_str());
+        throw 1;
+    }
+
+    if (swtrace != "0" && swtrace != "1")
+    {
+        master->print_error("\"%s\" is an illegal value for swtrace\n", swtrace.c_str());
+        throw 1;
+    }
+
+    // The events are stored relative to the creation of the model, which is close in time for all processes.
+    trace_start = master->get_wall_clock_time();
+}
+
+Timing::~Timing()
+{
+    if (timingfile)
+        std::fclose(timingfile);
+
+    // Write the remaining events and close the list of events.
+    if (swtrace == "1")
+    {
+        write_trace();
+        if (tracefile)
+        {
+            std::fprintf(tracefile, "\n]}\n");
+            std::fclose(tracefile);
+        }
+    }
+}
+
+int Timing::get_timer(const std::string& name)
+{
+    const int ntimers = timers.size();
+    for (int n=0; n<ntimers; ++n)
+        if (timers[n].name == name)
+            return n;
+
+    Timer timer = {name, 0., 0., 0};
+    timers.push_back(timer);
+    return ntimers;
+}
+
+void Timing::start(const std::string& name)
+{
+    if (swtiming == "0" && swtrace == "0")
+        return;
+
+    // Make sure the kernels of the previous module are not counted.
+    #ifdef USECUDA
+    cudaDeviceSynchronize();
+    #endif
+
+    timers[get_timer(name)].start = master->get_wall_clock_time();
+}
+
+void Timing::stop(const std::string& name)
+{
+    if (swtiming == "0" && swtrace == "0")
+        return;
+
+    #ifdef USECUDA
+    cudaDeviceSynchronize();
+    #endif
+
+    const double end = master->get_wall_clock_time();
+
+    const int n = get_timer(name);
+    timers[n].total += end - timers[n].start;
+    ++timers[n].ncalls;
+
+    if (swtrace == "1")
+    {
+        Event event = {n, timers[n].start, end};
+        events.push_back(event);
+    }
+}
+
+void Timing::exec(const int iteration, const double time)
+{
+    // Flush the events, such that the memory use of the trace does not grow during the run.
+    if (swtrace == "1")
+        write_trace();
+
+    if (swtiming == "0")
+        return;
+
+    // Open the file and write the header at the first write. All processes disable
+    // the timing if the file cannot be opened, as they take part in the reductions.
+    if (!timing_open)
+    {
+        int nerror = 0;
+        std::string timingname = master->simname + ".timing";
+        if (master->mpiid == 0)
+        {
+            timingfile = std::fopen(timingname.c_str(), "a");
+            if (timingfile == 0)
+                ++nerror;
+            else
+            {
+                std::setvbuf(timingfile, NULL, _IOLBF, 1024);
+                std::fprintf(timingfile, "%8s %11s %-10s %8s %11s %11s %11s\n",
+                        "ITER", "TIME", "MODULE", "NCALLS", "MIN", "MEAN", "MAX");
+            }
+        }
+
+        master->broadcast(&nerror, 1);
+        if (nerror)
+        {
+            master->print_warning("Timing file \"%s\" cannot be written, timing is disabled\n", timingname.c_str());
+            swtiming = "0";
+            return;
+        }
+
+        timing_open = true;
+    }
+
+    // All processes run the same modules in the same order, so the timers can be reduced as arrays.
+    const int ntimers = timers.size();
+
+    std::vector<double> tmin(ntimers);
+    std::vector<double> tmax(ntimers);
+    std::vector<double> tsum(ntimers);
+
+    for (int n=0; n<ntimers; ++n)
+    {
+        tmin[n] = timers[n].total;
+        tmax[n] = timers[n].total;
+        tsum[n] = timers[n].total;
+    }
+
+    // The reductions of the timing are not counted as communication of the model.
+    if (ntimers > 0)
+    {
+        master->pause_comm_profile();
+        master->min(tmin.data(), ntimers);
+        master->max(tmax.data(), ntimers);
+        master->sum(tsum.data(), ntimers);
+        master->resume_comm_profile();
+    }
+
+    if (master->mpiid == 0)
+    {
+        for (int n=0; n<ntimers; ++n)
+            std::fprintf(timingfile, "%8d %11.3E %-10s %8d %11.4E %11.4E %11.4E\n",
+                    iteration, time, timers[n].name.c_str(), timers[n].ncalls,
+                    tmin[n], tsum[n]/master->nprocs, tmax[n]);
+    }
+
+    // Reset the timers for the next interval.
+    for (std::vector<Timer>::iterator it=timers.begin(); it!=timers.end(); ++it)
+    {
+        it->total  = 0.;
+        it->ncalls = 0;
+    }
+}
+
+// Write the stored events to the trace file of this process in the Chrome trace event format,
+// which can be opened in chrome://tracing or Perfetto. Each process is shown as a separate row.
+void Timing::write_trace()
+{
+    if (tracefile == 0)
+    {
+        char filename[256];
+        std::snprintf(filename, 256, "%s.trace.%05d.json", master->simname.c_str(), master->mpiid);
+        tracefile = std::fopen(filename, "w");
+        if (tracefile == 0)
+        {
+            // The trace files are per process, so the failing process reports it instead of the master.
+            std::fprintf(stderr, "WARNING: Trace file \"%s\" cannot be written on rank %d, tracing is disabled\n",
+                         filename, master->mpiid);
+            swtrace = "0";
+            events.clear();
+            return;
+        }
+
+        std::fprintf(tracefile, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+        std::fprintf(tracefile, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": %d, \"tid\": 0, \"args\": {\"name\": \"rank %d\"}}",
+                master->mpiid, master->mpiid);
+    }
+
+    // The time stamps and durations are in microseconds.
+    for (std::vector<Event>::const_iterator it=events.begin(); it!=events.end(); ++it)
+        std::fprintf(tracefile, ",\n{\"name\": \"%s\", \"ph\": \"X\", \"pid\": %d, \"tid\": 0, \"ts\": %.3f, \"dur\": %.3f}",
+                timers[it->timer].name.c_str(), master->mpiid,
+                (it->start - trace_start)*1.e6, (it->end - it->start)*1.e6);
+
+    std::fflush(tracefile);
+    events.clear();
+}